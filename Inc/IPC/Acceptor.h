@@ -12,7 +12,9 @@
 #include "detail/RandomString.h"
 #include "detail/Apply.h"
 #include <memory>
+#include <vector>
 #include <future>
+#include <mutex>
 
 
 namespace IPC
@@ -25,14 +27,42 @@ namespace IPC
     public:
         using Connection = Connection<Input, Output, Traits>;
 
+        /// When slotCount is not zero, the acceptor keeps that many connections pre-created and
+        /// advertised in the host info memory. Connectors claim them without a round trip and the
+        /// acceptor refills a slot after handing out its connection. Slots which the connector
+        /// failed to open or whose connector died are refilled on later connects. Slot channels
+        /// always use named memory since the connector is not known in advance.
         template <typename Handler>
-        Acceptor(const char* name, Handler&& handler, ChannelSettings<Traits> channelSettings = {}, std::size_t hostInfoMemorySize = 0)
-            : m_acceptorHostInfo{ std::make_shared<AcceptorHostInfoMemory>(name, channelSettings, hostInfoMemorySize) },
+        Acceptor(
+            const char* name,
+            Handler&& handler,
+            ChannelSettings<Traits> channelSettings = {},
+            std::size_t hostInfoMemorySize = 0,
+            std::size_t slotCount = 0)
+            : m_acceptorHostInfo{ std::make_shared<AcceptorHostInfoMemory>(name, channelSettings, hostInfoMemorySize, slotCount) },
               m_pingChannel{ create_only, nullptr, m_acceptorHostInfo, channelSettings.GetWaitHandleFactory(), channelSettings.GetReceiverFactory() },
+              m_slotChannel{ slotCount != 0
+                ? std::make_unique<InputChannel<detail::AcceptorSlotClaim, Traits>>(
+                    create_only, nullptr, m_acceptorHostInfo, channelSettings.GetWaitHandleFactory(), channelSettings.GetReceiverFactory())
+                : nullptr },
               m_closeEvent{ create_only, true, false, (*m_acceptorHostInfo)->m_acceptorCloseEventName.c_str() },
               m_handler{ std::forward<Handler>(handler) },
-              m_channelFactory{ std::move(channelSettings) }
+              m_channelFactory{ std::move(channelSettings) },
+              m_slots(slotCount)
         {
+            if (m_slotChannel)
+            {
+                for (std::size_t i = 0; i != slotCount; ++i)
+                {
+                    FillSlot(i);
+                }
+
+                if (!m_slotChannel->RegisterReceiver([this](detail::AcceptorSlotClaim&& claim) { AcceptSlot(claim.m_index); }))
+                {
+                    throw Exception{ "Failed to register a receiver." };
+                }
+            }
+
             if (!m_pingChannel.RegisterReceiver(
                 [this](detail::ConnectorPingInfo&& pingInfo)
                 {
@@ -63,13 +93,22 @@ namespace IPC
             m_closeEvent.Signal();
 
             m_pingChannel.UnregisterReceiver();
+
+            if (m_slotChannel)
+            {
+                m_slotChannel->UnregisterReceiver();
+            }
         }
 
     private:
         class AcceptorHostInfoMemory : public SharedMemory
         {
         public:
-            AcceptorHostInfoMemory(const char* name, const ChannelSettings<Traits>& channelSettings, std::size_t hostInfoMemorySize)
+            AcceptorHostInfoMemory(
+                const char* name,
+                const ChannelSettings<Traits>& channelSettings,
+                std::size_t hostInfoMemorySize,
+                std::size_t slotCount)
                 : SharedMemory{ create_only, name, hostInfoMemorySize != 0 ? hostInfoMemorySize : (1 * 1024 * 1024) }
             {
                 InvokeAtomic(
@@ -90,6 +129,19 @@ namespace IPC
                         {
                             m_info->m_settings.m_commonOutputMemoryName.emplace(memory->GetName().c_str(), allocator);
                         }
+
+                        if (slotCount != 0)
+                        {
+                            auto slots = GetAllocator<detail::AcceptorSlot>().allocate(slotCount);
+
+                            for (std::size_t i = 0; i != slotCount; ++i)
+                            {
+                                new (&slots[i]) detail::AcceptorSlot{ allocator };
+                            }
+
+                            m_info->m_slots = slots;
+                            m_info->m_slotCount = static_cast<std::uint32_t>(slotCount);
+                        }
                     });
             }
 
@@ -98,6 +150,11 @@ namespace IPC
                 return m_info;
             }
 
+            detail::AcceptorSlot& GetSlot(std::size_t index)
+            {
+                return m_info->m_slots[index];
+            }
+
         private:
             detail::AcceptorHostInfo* m_info{ nullptr };
         };
@@ -178,14 +235,174 @@ namespace IPC
                 auto channelFactoryInstance = channelFactory.MakeInstance();
 
                 // Open in a strict order. Must be the reverse of the connector.
-                auto input = channelFactoryInstance.template OpenInput<typename Server::InputPacket>(pingInfo.m_connectorInfoChannelName.c_str());
-                auto output = channelFactoryInstance.template OpenOutput<typename Server::OutputPacket>(pingInfo.m_acceptorInfoChannelName.c_str());
+                auto input = channelFactoryInstance.template OpenInput<typename Server::InputPacket>(
+                    pingInfo.m_connectorInfoChannelName.c_str(), pingInfo.m_connectorInfoChannelMemory);
+                auto output = channelFactoryInstance.template OpenOutput<typename Server::OutputPacket>(
+                    pingInfo.m_acceptorInfoChannelName.c_str(), pingInfo.m_acceptorInfoChannelMemory);
 
                 return std::make_pair(std::move(input), std::move(output));
             }
         };
 
 
+        struct Slot
+        {
+            detail::KernelEvent m_closeEvent;
+            detail::ChannelHolderOf<Input, Output, Traits> m_channels;
+        };
+
+
+        void FillSlot(std::size_t index)
+        {
+            auto& info = m_acceptorHostInfo->GetSlot(index);
+
+            info.m_state.store(detail::AcceptorSlot::MakeState(detail::AcceptorSlot::State::Free), std::memory_order_relaxed);
+            info.m_closeEventName.assign(detail::GenerateRandomString().c_str());
+            info.m_acceptorChannelName.assign(detail::GenerateRandomString().c_str());
+            info.m_connectorChannelName.assign(detail::GenerateRandomString().c_str());
+
+            auto channelFactory = m_channelFactory;
+            channelFactory.SetAnonymousMemory(false);   // Sections cannot be shared with an unknown process.
+
+            auto channelFactoryInstance = channelFactory.MakeInstance();
+
+            m_slots[index] = std::make_unique<Slot>(Slot{
+                detail::KernelEvent{ create_only, false, false, info.m_closeEventName.c_str() },
+                CreateSlotChannels(info, channelFactoryInstance) });
+
+            info.m_state.store(detail::AcceptorSlot::MakeState(detail::AcceptorSlot::State::Ready), std::memory_order_release);
+        }
+
+        void TryFillSlot(std::size_t index)
+        {
+            try
+            {
+                FillSlot(index);
+            }
+            catch (...)
+            {
+                // The slot stays free and connectors fall back to the ping channel.
+            }
+        }
+
+        void AcceptSlot(std::uint32_t index)
+        {
+            std::unique_ptr<Slot> slot;
+            std::uint32_t processId{};
+
+            {
+                std::lock_guard<std::mutex> guard{ *m_slotLock };
+
+                if (index < m_slots.size())
+                {
+                    auto state = m_acceptorHostInfo->GetSlot(index).m_state.load(std::memory_order_acquire);
+
+                    if (detail::AcceptorSlot::GetState(state) == detail::AcceptorSlot::State::Claimed)
+                    {
+                        slot = std::move(m_slots[index]);
+                        processId = detail::AcceptorSlot::GetProcessId(state);
+                    }
+                }
+            }
+
+            std::packaged_task<std::unique_ptr<Connection>()> task{
+                [&]
+                {
+                    if (!slot)
+                    {
+                        throw Exception{ "Unexpected slot is claimed." };
+                    }
+
+                    return detail::ApplyTuple(
+                        [&](auto&&... channels)
+                        {
+                            return std::make_unique<Connection>(
+                                slot->m_closeEvent,
+                                slot->m_closeEvent,
+                                detail::KernelProcess{ processId },
+                                m_channelFactory.GetWaitHandleFactory(),
+                                std::forward<decltype(channels)>(channels)...);
+                        },
+                        std::move(slot->m_channels));
+                } };
+
+            auto result = task.get_future();
+
+            task();
+
+            m_handler(std::move(result));
+
+            RecycleSlots();
+        }
+
+        /// Refills the slots which are empty, failed by the connector or claimed by a process
+        /// which died before handing the slot over.
+        void RecycleSlots()
+        {
+            std::lock_guard<std::mutex> guard{ *m_slotLock };
+
+            for (std::size_t i = 0; i != m_slots.size(); ++i)
+            {
+                if (m_slots[i])
+                {
+                    auto state = m_acceptorHostInfo->GetSlot(i).m_state.load(std::memory_order_acquire);
+
+                    switch (detail::AcceptorSlot::GetState(state))
+                    {
+                    case detail::AcceptorSlot::State::Claimed:
+                        if (IsProcessAlive(detail::AcceptorSlot::GetProcessId(state)))
+                        {
+                            continue;
+                        }
+                        break;
+
+                    case detail::AcceptorSlot::State::Failed:
+                        break;
+
+                    default:
+                        continue;
+                    }
+
+                    m_slots[i].reset();
+                }
+
+                TryFillSlot(i);
+            }
+        }
+
+        static bool IsProcessAlive(std::uint32_t processId)
+        {
+            try
+            {
+                return !detail::KernelProcess{ processId }.IsSignaled();
+            }
+            catch (const std::exception&)
+            {
+                return false;   // The process is gone.
+            }
+        }
+
+        template <typename I = Input, typename O = Output, std::enable_if_t<!std::is_void<I>::value && !std::is_void<O>::value>* = nullptr>
+        auto CreateSlotChannels(const detail::AcceptorSlot& info, typename ChannelFactory::Instance& channelFactoryInstance)
+        {
+            // Create in a strict order. Must be the same as the connector opens them (important when both use the same memory).
+            auto input = CreateSlotChannels<Input, void>(info, channelFactoryInstance);
+            auto output = CreateSlotChannels<void, Output>(info, channelFactoryInstance);
+            return std::tuple_cat(std::move(input), std::move(output));
+        }
+
+        template <typename I = Input, typename O = Output, std::enable_if_t<!std::is_void<I>::value && std::is_void<O>::value>* = nullptr>
+        auto CreateSlotChannels(const detail::AcceptorSlot& info, typename ChannelFactory::Instance& channelFactoryInstance)
+        {
+            return std::make_tuple(channelFactoryInstance.template CreateInput<Input>(info.m_acceptorChannelName.c_str()));
+        }
+
+        template <typename I = Input, typename O = Output, std::enable_if_t<std::is_void<I>::value && !std::is_void<O>::value>* = nullptr>
+        auto CreateSlotChannels(const detail::AcceptorSlot& info, typename ChannelFactory::Instance& channelFactoryInstance)
+        {
+            return std::make_tuple(channelFactoryInstance.template CreateOutput<Output>(info.m_connectorChannelName.c_str()));
+        }
+
         void HostServer(detail::ConnectorPingInfo&& pingInfo)
         {
             m_servers.Accept(
@@ -207,6 +424,8 @@ namespace IPC
                             typename ChannelFactory::Instance&& channelFactoryInstance,
                             auto&& callback)
                         {
+                            RecycleSlots();
+
                             std::packaged_task<std::unique_ptr<Connection>()> task{
                                 [&]
                                 {
@@ -238,51 +457,83 @@ namespace IPC
         {
             acceptorInfo.m_closeEventName.assign(detail::GenerateRandomString().c_str());
 
-            return detail::ApplyTuple(
-                [&](auto&&... channels)
-                {
-                    detail::KernelEvent closeEvent{ create_only, false, false, acceptorInfo.m_closeEventName.c_str() };
-                    auto connection = std::make_unique<Connection>(
-                        closeEvent,
-                        closeEvent,
-                        std::move(process),
-                        channelFactoryInstance.GetWaitHandleFactory(),
-                        std::forward<decltype(channels)>(channels)...);
-
-                    callback(std::move(acceptorInfo));
-
-                    return connection;
-                },
-                CollectChannels(connectorInfo, acceptorInfo, channelFactoryInstance));
+            const auto processId = process.GetId();
+
+            try
+            {
+                return detail::ApplyTuple(
+                    [&](auto&&... channels)
+                    {
+                        detail::KernelEvent closeEvent{ create_only, false, false, acceptorInfo.m_closeEventName.c_str() };
+                        auto connection = std::make_unique<Connection>(
+                            closeEvent,
+                            closeEvent,
+                            std::move(process),
+                            channelFactoryInstance.GetWaitHandleFactory(),
+                            std::forward<decltype(channels)>(channels)...);
+
+                        callback(std::move(acceptorInfo));
+
+                        return connection;
+                    },
+                    CollectChannels(connectorInfo, acceptorInfo, channelFactoryInstance, processId));
+            }
+            catch (...)
+            {
+                // The connector never receives the response, so close the handle duplicated into it.
+                detail::ChannelFactory<void>::InstanceBase::UnshareMemory(acceptorInfo.m_channelMemory, processId);
+                throw;
+            }
         }
 
         template <typename I = Input, typename O = Output, std::enable_if_t<!std::is_void<I>::value && !std::is_void<O>::value>* = nullptr>
-        auto CollectChannels(detail::ConnectorInfo& connectorInfo, detail::AcceptorInfo& acceptorInfo, typename ChannelFactory::Instance& channelFactoryInstance)
+        auto CollectChannels(
+            detail::ConnectorInfo& connectorInfo,
+            detail::AcceptorInfo& acceptorInfo,
+            typename ChannelFactory::Instance& channelFactoryInstance,
+            std::uint32_t processId)
         {
             // Make sure opening input channel happens before creating output (important when both must use the same memory).
-            auto input = CollectChannels<Input, void>(connectorInfo, acceptorInfo, channelFactoryInstance);
-            auto output = CollectChannels<void, Output>(connectorInfo, acceptorInfo, channelFactoryInstance);
+            auto input = CollectChannels<Input, void>(connectorInfo, acceptorInfo, channelFactoryInstance, processId);
+            auto output = CollectChannels<void, Output>(connectorInfo, acceptorInfo, channelFactoryInstance, processId);
             return std::tuple_cat(std::move(input), std::move(output));
         }
 
         template <typename I = Input, typename O = Output, std::enable_if_t<!std::is_void<I>::value && std::is_void<O>::value>* = nullptr>
-        auto CollectChannels(detail::ConnectorInfo& connectorInfo, detail::AcceptorInfo& /*acceptorInfo*/, typename ChannelFactory::Instance& channelFactoryInstance)
+        auto CollectChannels(
+            detail::ConnectorInfo& connectorInfo,
+            detail::AcceptorInfo& /*acceptorInfo*/,
+            typename ChannelFactory::Instance& channelFactoryInstance,
+            std::uint32_t /*processId*/)
         {
-            return std::make_tuple(channelFactoryInstance.template OpenInput<Input>(connectorInfo.m_channelName.c_str()));
+            return std::make_tuple(channelFactoryInstance.template OpenInput<Input>(
+                connectorInfo.m_channelName.c_str(), connectorInfo.m_channelMemory));
         }
 
         template <typename I = Input, typename O = Output, std::enable_if_t<std::is_void<I>::value && !std::is_void<O>::value>* = nullptr>
-        auto CollectChannels(detail::ConnectorInfo& /*connectorInfo*/, detail::AcceptorInfo& acceptorInfo, typename ChannelFactory::Instance& channelFactoryInstance)
+        auto CollectChannels(
+            detail::ConnectorInfo& /*connectorInfo*/,
+            detail::AcceptorInfo& acceptorInfo,
+            typename ChannelFactory::Instance& channelFactoryInstance,
+            std::uint32_t processId)
         {
             acceptorInfo.m_channelName.assign(detail::GenerateRandomString().c_str());
-            return std::make_tuple(channelFactoryInstance.template CreateOutput<Output>(acceptorInfo.m_channelName.c_str()));
+
+            auto channel = channelFactoryInstance.template CreateOutput<Output>(acceptorInfo.m_channelName.c_str());
+
+            acceptorInfo.m_channelMemory = detail::ChannelFactory<void>::InstanceBase::ShareMemory(*channel.GetMemory(), processId);
+
+            return std::make_tuple(std::move(channel));
         }
 
         std::shared_ptr<AcceptorHostInfoMemory> m_acceptorHostInfo;
         InputChannel<detail::ConnectorPingInfo, Traits> m_pingChannel;
+        std::unique_ptr<InputChannel<detail::AcceptorSlotClaim, Traits>> m_slotChannel;
         detail::KernelEvent m_closeEvent;
         detail::Callback<void(std::future<std::unique_ptr<Connection>>)> m_handler;
         ChannelFactory m_channelFactory;
+        std::vector<std::unique_ptr<Slot>> m_slots;
+        std::unique_ptr<std::mutex> m_slotLock{ std::make_unique<std::mutex>() };   // Keeps the acceptor movable.
         ComponentCollection<std::list<std::unique_ptr<AcceptorServer>>> m_servers;  // Must be the last member.
     };
 
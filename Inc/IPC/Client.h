@@ -4,7 +4,11 @@
 #include "detail/PacketConnectionHolder.h"
 #include "detail/Packet.h"
 #include "detail/Callback.h"
+#include "Completion.h"
+#include "Exception.h"
 #include <future>
+#include <vector>
+#include <iterator>
 
 
 namespace IPC
@@ -96,7 +100,141 @@ namespace IPC
             return result;
         }
 
+        /// Same as the std::future overload, but returns a pooled completion which does not
+        /// allocate per call and supports continuations.
+        template <typename OtherRequest, typename... TransactionArgs, typename U = Response, std::enable_if_t<!std::is_void<U>::value>* = nullptr>
+        Completion<Response> Call(OtherRequest&& request, TransactionArgs&&... transactionArgs)
+        {
+            auto completion = detail::MakeCompletion<Response>();
+
+            operator()(std::forward<OtherRequest>(request), std::move(completion.second), std::forward<TransactionArgs>(transactionArgs)...);
+
+            return std::move(completion.first);
+        }
+
+        /// Sends a prefix of the requests range with a single receiver notification and invokes
+        /// a copy of the callback for each response. Returns the number of sent requests.
+        /// Note that all requests are consumed from the range, including rejected ones.
+        template <typename Iterator, typename Callback, typename... TransactionArgs, typename U = Response, std::enable_if_t<!std::is_void<U>::value>* = nullptr,
+            decltype(std::declval<Callback>()(std::declval<U>()))* = nullptr>
+        std::size_t TrySendRange(Iterator first, Iterator last, const Callback& callback, const TransactionArgs&... transactionArgs)
+        {
+            auto& transactionManager = GetTransactionManager();
+
+            PacketBuffer buffer;
+            auto& packets = *buffer;
+            packets.reserve(static_cast<std::size_t>(std::distance(first, last)));
+
+            auto endTransactions = [&](auto it)
+            {
+                for (; it != packets.end(); ++it)
+                {
+                    transactionManager.EndTransaction(it->GetId());
+                }
+            };
+
+            std::size_t count{ 0 };
+
+            try
+            {
+                for (; first != last; ++first)
+                {
+                    auto&& id = transactionManager.BeginTransaction(callback, transactionArgs...);
+
+                    try
+                    {
+                        packets.emplace_back(id, *first);
+                    }
+                    catch (...)
+                    {
+                        transactionManager.EndTransaction(id);
+                        throw;
+                    }
+                }
+
+                count = SendPackets(packets);
+            }
+            catch (...)
+            {
+                endTransactions(packets.begin());
+                throw;
+            }
+
+            endTransactions(packets.begin() + count);
+
+            return count;
+        }
+
+        /// Sends a prefix of the requests range with a single receiver notification.
+        /// Returns the number of sent requests.
+        /// Note that all requests are consumed from the range, including rejected ones.
+        template <typename Iterator, typename U = Response, std::enable_if_t<std::is_void<U>::value>* = nullptr>
+        std::size_t TrySendRange(Iterator first, Iterator last)
+        {
+            PacketBuffer buffer;
+            auto& packets = *buffer;
+            packets.reserve(static_cast<std::size_t>(std::distance(first, last)));
+
+            for (; first != last; ++first)
+            {
+                packets.emplace_back(*first);
+            }
+
+            return SendPackets(packets);
+        }
+
+        /// Sends all the requests, retrying the rest while the queue drains.
+        /// Throws when nothing more can be sent.
+        template <typename Iterator, typename... Args>
+        void SendBatch(Iterator first, Iterator last, const Args&... args)
+        {
+            while (first != last)
+            {
+                auto count = TrySendRange(first, last, args...);
+
+                if (count == 0)
+                {
+                    throw Exception{ "Out of buffers." };
+                }
+
+                std::advance(first, count);
+            }
+        }
+
     private:
+        /// Lends the packet buffer of the calling thread to a batch, so that steady batches
+        /// do not allocate. Nested batches get an empty buffer of their own.
+        class PacketBuffer
+        {
+        public:
+            PacketBuffer()
+                : m_packets{ std::move(GetCache()) }
+            {}
+
+            PacketBuffer(const PacketBuffer& other) = delete;
+            PacketBuffer& operator=(const PacketBuffer& other) = delete;
+
+            ~PacketBuffer()
+            {
+                m_packets.clear();
+                GetCache() = std::move(m_packets);
+            }
+
+            std::vector<OutputPacket>& operator*()
+            {
+                return m_packets;
+            }
+
+        private:
+            static std::vector<OutputPacket>& GetCache()
+            {
+                static thread_local std::vector<OutputPacket> s_packets;
+                return s_packets;
+            }
+
+            std::vector<OutputPacket> m_packets;
+        };
+
         auto& GetTransactionManager()
         {
             return this->GetContext();
@@ -108,6 +246,12 @@ namespace IPC
             this->GetConnection().GetOutputChannel().Send(OutputPacket{ std::forward<Args>(args)..., std::forward<OtherRequest>(request) });
         }
 
+        std::size_t SendPackets(std::vector<OutputPacket>& packets)
+        {
+            return this->GetConnection().GetOutputChannel().TrySendRange(
+                std::make_move_iterator(packets.begin()), std::make_move_iterator(packets.end()));
+        }
+
         template <typename Packet = InputPacket, typename U = Response, std::enable_if_t<!std::is_void<U>::value>* = nullptr>
         void ResponseHandler(Packet&& packet)
         {
@@ -0,0 +1,210 @@
+#pragma once
+
+#include "Client.h"
+#include "Exception.h"
+#include "detail/Callback.h"
+#include <memory>
+#include <vector>
+#include <future>
+#include <atomic>
+#include <limits>
+
+
+namespace IPC
+{
+    /// Keeps several auto-reconnecting clients connected to the same acceptor and spreads calls
+    /// across them. Each member reconnects on its own, calls skip members which are not connected.
+    template <typename Request, typename Response, typename Traits = DefaultTraits>
+    class ClientPool
+    {
+    public:
+        using Client = Client<Request, Response, Traits>;
+        using Accessor = detail::Callback<std::shared_ptr<Client>()>;
+
+        static_assert(!std::is_void<Response>::value, "Response cannot be void.");
+
+        enum class Balancing
+        {
+            RoundRobin,
+            LeastOutstanding,   // The member with the fewest calls awaiting a response.
+            KeyHash             // The member selected by the key passed to Call, same keys use the same member.
+        };
+
+        ClientPool(std::vector<Accessor> accessors, Balancing balancing)
+            : m_balancing{ balancing }
+        {
+            if (accessors.empty())
+            {
+                throw Exception{ "Client pool cannot be empty." };
+            }
+
+            m_members.reserve(accessors.size());
+
+            for (auto& accessor : accessors)
+            {
+                m_members.push_back({ std::move(accessor), std::make_shared<std::atomic_size_t>(0) });
+            }
+        }
+
+        template <typename OtherRequest, typename Callback, typename... TransactionArgs,
+            decltype(std::declval<Callback>()(std::declval<Response>()))* = nullptr>
+        void operator()(OtherRequest&& request, Callback&& callback, TransactionArgs&&... transactionArgs)
+        {
+            Call(0, std::forward<OtherRequest>(request), std::forward<Callback>(callback), std::forward<TransactionArgs>(transactionArgs)...);
+        }
+
+        template <typename OtherRequest, typename... TransactionArgs>
+        std::future<Response> operator()(OtherRequest&& request, TransactionArgs&&... transactionArgs)
+        {
+            return Call(0, std::forward<OtherRequest>(request), std::forward<TransactionArgs>(transactionArgs)...);
+        }
+
+        /// Same as operator() with the key used by Balancing::KeyHash, ignored otherwise.
+        template <typename OtherRequest, typename Callback, typename... TransactionArgs,
+            decltype(std::declval<Callback>()(std::declval<Response>()))* = nullptr>
+        void Call(std::size_t key, OtherRequest&& request, Callback&& callback, TransactionArgs&&... transactionArgs)
+        {
+            std::size_t index;
+            auto client = Acquire(Select(key), index);
+
+            (*client)(
+                std::forward<OtherRequest>(request),
+                [inFlight = InFlight{ m_members[index].m_inFlight }, callback = std::forward<Callback>(callback)](Response&& response) mutable
+                {
+                    inFlight.Release();     // Before the callback, so the count is current once the response is observed.
+                    callback(std::move(response));
+                },
+                std::forward<TransactionArgs>(transactionArgs)...);
+        }
+
+        template <typename OtherRequest, typename... TransactionArgs>
+        std::future<Response> Call(std::size_t key, OtherRequest&& request, TransactionArgs&&... transactionArgs)
+        {
+            std::packaged_task<Response(Response&&)> callback{ [](Response&& response) { return response; } };
+
+            auto result = callback.get_future();
+
+            Call(key, std::forward<OtherRequest>(request), std::move(callback), std::forward<TransactionArgs>(transactionArgs)...);
+
+            return result;
+        }
+
+        std::size_t GetSize() const
+        {
+            return m_members.size();
+        }
+
+        /// Returns the number of calls made through the member which have not completed, failed or timed out yet.
+        std::size_t GetInFlightCount(std::size_t index) const
+        {
+            return m_members.at(index).m_inFlight->load(std::memory_order_relaxed);
+        }
+
+        /// Returns the client of the member or throws when it is not connected.
+        std::shared_ptr<Client> GetClient(std::size_t index) const
+        {
+            return m_members.at(index).m_accessor();
+        }
+
+    private:
+        struct Member
+        {
+            Accessor m_accessor;
+            std::shared_ptr<std::atomic_size_t> m_inFlight;     // Shared with the pending callbacks which may outlive the pool.
+        };
+
+        /// Counts a call until its callback is invoked or dropped by the transaction manager.
+        class InFlight
+        {
+        public:
+            explicit InFlight(std::shared_ptr<std::atomic_size_t> count)
+                : m_count{ std::move(count) }
+            {
+                ++*m_count;
+            }
+
+            InFlight(InFlight&& other) = default;
+
+            ~InFlight()
+            {
+                Release();
+            }
+
+            void Release()
+            {
+                if (m_count)
+                {
+                    --*m_count;
+                    m_count.reset();
+                }
+            }
+
+        private:
+            std::shared_ptr<std::atomic_size_t> m_count;
+        };
+
+
+        std::size_t Select(std::size_t key) const
+        {
+            auto size = m_members.size();
+
+            switch (m_balancing)
+            {
+            case Balancing::KeyHash:
+                return key % size;
+
+            case Balancing::LeastOutstanding:
+                {
+                    auto start = (*m_next)++;     // Rotates the start to spread ties.
+                    auto best = start % size;
+                    auto bestCount = (std::numeric_limits<std::size_t>::max)();
+
+                    for (std::size_t i = 0; i != size; ++i)
+                    {
+                        auto index = (start + i) % size;
+                        auto count = m_members[index].m_inFlight->load(std::memory_order_relaxed);
+
+                        if (count < bestCount)
+                        {
+                            best = index;
+                            bestCount = count;
+                        }
+                    }
+
+                    return best;
+                }
+
+            default:
+                return (*m_next)++ % size;
+            }
+        }
+
+        /// Returns the client of the selected member or of the next connected one.
+        std::shared_ptr<Client> Acquire(std::size_t selected, std::size_t& index) const
+        {
+            auto size = m_members.size();
+
+            for (std::size_t i = 0; i != size; ++i)
+            {
+                index = (selected + i) % size;
+
+                try
+                {
+                    return m_members[index].m_accessor();
+                }
+                catch (const Exception&)
+                {
+                    // The member is reconnecting, try the next one.
+                }
+            }
+
+            throw Exception{ "Connection is not available." };
+        }
+
+
+        std::vector<Member> m_members;
+        Balancing m_balancing;
+        std::unique_ptr<std::atomic_size_t> m_next{ std::make_unique<std::atomic_size_t>(0) };
+    };
+
+} // IPC
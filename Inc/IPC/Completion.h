@@ -0,0 +1,99 @@
+#pragma once
+
+#include "detail/Completion.h"
+#include <future>
+#include <chrono>
+#include <utility>
+#include <cassert>
+
+
+namespace IPC
+{
+    /// Single-shot result of an asynchronous call with the std::future interface. The state is
+    /// taken from a process-wide pool, so unlike std::future it does not allocate per call.
+    /// Waiting spins for a while before blocking. When the producer is dropped without a value,
+    /// get throws std::future_error with std::future_errc::broken_promise.
+    template <typename T>
+    class Completion
+    {
+    public:
+        Completion() = default;
+
+        explicit Completion(detail::CompletionHolder<T> holder)
+            : m_holder{ std::move(holder) }
+        {}
+
+        Completion(Completion&& other) = default;
+        Completion& operator=(Completion&& other) = default;
+
+        bool valid() const
+        {
+            return static_cast<bool>(m_holder);
+        }
+
+        bool is_ready() const
+        {
+            assert(valid());
+            return m_holder->IsReady();
+        }
+
+        void wait() const
+        {
+            assert(valid());
+            m_holder->Wait();
+        }
+
+        template <typename Rep, typename Period>
+        std::future_status wait_for(const std::chrono::duration<Rep, Period>& timeout) const
+        {
+            assert(valid());
+
+            return m_holder->WaitUntil(std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout))
+                ? std::future_status::ready
+                : std::future_status::timeout;
+        }
+
+        /// Waits for and returns the result. The completion is no longer valid afterwards.
+        T get()
+        {
+            assert(valid());
+            auto holder = std::move(m_holder);
+            return holder->GetValue();
+        }
+
+        /// Invokes the function with this completion once it is ready, either on the thread that
+        /// completes it or immediately when it is already ready. The completion is consumed.
+        template <typename Function>
+        void then(Function&& func)
+        {
+            assert(valid());
+            auto& state = *m_holder;
+
+            state.SetContinuation(
+                [self = std::move(*this), func = std::forward<Function>(func)]() mutable
+                {
+                    func(std::move(self));
+                });
+        }
+
+    private:
+        detail::CompletionHolder<T> m_holder;
+    };
+
+
+    namespace detail
+    {
+        /// Creates a completion with the matching response callback.
+        template <typename T>
+        std::pair<Completion<T>, CompletionSource<T>> MakeCompletion()
+        {
+            auto pool = GetCompletionPool<T>();
+            auto item = pool->Take();
+
+            return{
+                Completion<T>{ CompletionHolder<T>{ pool, item.first, item.second } },
+                CompletionSource<T>{ CompletionHolder<T>{ std::move(pool), item.first, item.second } } };
+        }
+
+    } // detail
+} // IPC
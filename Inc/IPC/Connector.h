@@ -14,6 +14,8 @@
 #include <map>
 #include <type_traits>
 #include <future>
+#include <atomic>
+#include <cstdint>
 
 
 namespace IPC
@@ -87,6 +89,9 @@ namespace IPC
         }
 #endif
 
+        /// When the acceptor has a ready slot, the connection is made without a round trip and
+        /// the callback is invoked on the calling thread before Connect returns. Otherwise it is
+        /// invoked asynchronously once the acceptor responds.
         template <typename Callback, typename... TransactionArgs, typename U = std::future<std::unique_ptr<Connection>>,
             decltype(std::declval<Callback>()(std::declval<U>()))* = nullptr>
         void Connect(const char* acceptorName, Callback&& callback, TransactionArgs&&... transactionArgs)
@@ -125,26 +130,39 @@ namespace IPC
             };
 
             auto guaranteedCallback = std::make_shared<GuaranteedCallback>(std::forward<Callback>(callback));
+            std::unique_ptr<Connection> connection;
 
             try
             {
-                InvokeAcceptor(
-                    BeginConnect(acceptorName),
-                    [this, guaranteedCallback](auto&& state) mutable
-                    {
-                        std::packaged_task<std::unique_ptr<Connection>()> task{ [&] { return EndConnect(state); } };
-                        auto result = task.get_future();
+                connection = TryConnectSlot(acceptorName);
 
-                        task();
+                if (!connection)
+                {
+                    InvokeAcceptor(
+                        BeginConnect(acceptorName),
+                        [this, guaranteedCallback](auto&& state) mutable
+                        {
+                            std::packaged_task<std::unique_ptr<Connection>()> task{ [&] { return EndConnect(state); } };
+                            auto result = task.get_future();
 
-                        (*guaranteedCallback)(std::move(result));
-                    },
-                    std::forward<TransactionArgs>(transactionArgs)...);
+                            task();
+
+                            (*guaranteedCallback)(std::move(result));
+                        },
+                        std::forward<TransactionArgs>(transactionArgs)...);
+
+                    return;
+                }
             }
             catch (...)
             {
                 (*guaranteedCallback)(std::current_exception());
+                return;
             }
+
+            std::promise<std::unique_ptr<Connection>> promise;
+            promise.set_value(std::move(connection));
+            (*guaranteedCallback)(promise.get_future());
         }
 
         template <typename... TransactionArgs>
@@ -166,6 +184,7 @@ namespace IPC
         public:
             ConnectorClient(
                 ChannelFactory channelFactory,
+                std::shared_ptr<SharedMemory> acceptorHostInfoMemory,
                 const detail::AcceptorHostInfo& acceptorHostInfo,
                 const detail::ConnectorPingInfo& pingInfo,
                 typename Traits::TransactionManagerFactory transactionManagerFactory,
@@ -173,6 +192,7 @@ namespace IPC
                 : ConnectorClient{
                     std::move(channelFactory),
                     CreateChannelsOrdered(pingInfo, channelFactory),
+                    std::move(acceptorHostInfoMemory),
                     acceptorHostInfo,
                     pingInfo,
                     std::move(transactionManagerFactory),
@@ -190,11 +210,38 @@ namespace IPC
                 return m_channelFactory;
             }
 
+            /// Claims a slot pre-created by the acceptor, or returns null when none is ready.
+            detail::AcceptorSlot* ClaimSlot()
+            {
+                const auto claimed = detail::AcceptorSlot::MakeState(
+                    detail::AcceptorSlot::State::Claimed, detail::KernelProcess::GetCurrentProcessId());
+
+                for (std::uint32_t i = 0; i != m_slotCount; ++i)
+                {
+                    auto& slot = m_slots[m_nextSlot++ % m_slotCount];
+                    auto state = detail::AcceptorSlot::MakeState(detail::AcceptorSlot::State::Ready);
+
+                    if (slot.m_state.compare_exchange_strong(state, claimed, std::memory_order_acquire))
+                    {
+                        return &slot;
+                    }
+                }
+
+                return nullptr;
+            }
+
+            /// Hands the claimed slot over to the acceptor once its channels are opened.
+            void NotifySlot(const detail::AcceptorSlot& slot)
+            {
+                m_slotChannel->Send(detail::AcceptorSlotClaim{ static_cast<std::uint32_t>(&slot - m_slots) });
+            }
+
         private:
             template <typename Channels>
             ConnectorClient(
                 ChannelFactory&& channelFactory,
                 Channels&& channels,
+                std::shared_ptr<SharedMemory>&& acceptorHostInfoMemory,
                 const detail::AcceptorHostInfo& acceptorHostInfo,
                 const detail::ConnectorPingInfo& pingInfo,
                 typename Traits::TransactionManagerFactory&& transactionManagerFactory,
@@ -212,7 +259,12 @@ namespace IPC
                     std::move(closeHandler),
                     std::move(transactionManagerFactory)(detail::Identity<typename ConnectorClient::Client::TransactionManager>{}) },
                   m_process{ std::move(process) },
-                  m_channelFactory{ std::move(channelFactory) }
+                  m_channelFactory{ std::move(channelFactory) },
+                  m_slotChannel{ acceptorHostInfo.m_slotCount != 0
+                    ? std::make_unique<OutputChannel<detail::AcceptorSlotClaim, Traits>>(open_only, nullptr, std::move(acceptorHostInfoMemory))
+                    : nullptr },
+                  m_slots{ acceptorHostInfo.m_slots.get() },
+                  m_slotCount{ acceptorHostInfo.m_slotCount }
             {}
 
             static auto CreateChannelsOrdered(const detail::ConnectorPingInfo& pingInfo, const ChannelFactory& channelFactory)
@@ -231,6 +283,10 @@ namespace IPC
 
             detail::KernelProcess m_process;
             ChannelFactory m_channelFactory;
+            std::unique_ptr<OutputChannel<detail::AcceptorSlotClaim, Traits>> m_slotChannel;   // Keeps the slots mapped.
+            detail::AcceptorSlot* m_slots;
+            std::uint32_t m_slotCount;
+            std::atomic<std::uint32_t> m_nextSlot{ 0 };
         };
 
         std::shared_ptr<ConnectorClient> TryCreateClient(const char* acceptorName)
@@ -254,6 +310,7 @@ namespace IPC
                             acceptorHostInfo.m_settings.m_commonInputMemoryName
                                 ? acceptorHostInfo.m_settings.m_commonInputMemoryName->c_str()
                                 : nullptr),
+                        acceptorInfoMemory,
                         acceptorHostInfo,
                         pingInfo,
                         m_transactionManagerFactory,
@@ -264,7 +321,25 @@ namespace IPC
 
             if (result)
             {
-                pingChannel.Send(pingInfo);
+                const auto& connection = client->GetConnection();
+
+                try
+                {
+                    pingInfo.m_connectorInfoChannelMemory = detail::ChannelFactory<void>::InstanceBase::ShareMemory(
+                        *connection.GetOutputChannel().GetMemory(), acceptorHostInfo.m_processId);
+                    pingInfo.m_acceptorInfoChannelMemory = detail::ChannelFactory<void>::InstanceBase::ShareMemory(
+                        *connection.GetInputChannel().GetMemory(), acceptorHostInfo.m_processId);
+
+                    pingChannel.Send(pingInfo);
+                }
+                catch (...)
+                {
+                    // The acceptor never sees the ping, so close the handles duplicated into it.
+                    detail::ChannelFactory<void>::InstanceBase::UnshareMemory(pingInfo.m_connectorInfoChannelMemory, acceptorHostInfo.m_processId);
+                    detail::ChannelFactory<void>::InstanceBase::UnshareMemory(pingInfo.m_acceptorInfoChannelMemory, acceptorHostInfo.m_processId);
+                    throw;
+                }
+
                 return client;
             }
 
@@ -321,6 +396,72 @@ namespace IPC
             return client;
         }
 
+        /// Connects through a slot pre-created by the acceptor without waiting for it.
+        /// Returns null when the acceptor has no ready slots or the claimed one cannot be opened.
+        std::unique_ptr<Connection> TryConnectSlot(const char* acceptorName)
+        {
+            auto client = GetClient(acceptorName);
+            auto slot = client->ClaimSlot();
+
+            if (!slot)
+            {
+                return{};
+            }
+
+            std::unique_ptr<Connection> connection;
+
+            try
+            {
+                auto channelFactoryInstance = client->GetChannelFactory().MakeInstance();
+                detail::KernelEvent closeEvent{ open_only, slot->m_closeEventName.c_str() };
+
+                connection = detail::ApplyTuple(
+                    [&](auto&&... channels)
+                    {
+                        return std::make_unique<Connection>(
+                            closeEvent,
+                            closeEvent,
+                            client->GetProcess(),
+                            channelFactoryInstance.GetWaitHandleFactory(),
+                            std::forward<decltype(channels)>(channels)...);
+                    },
+                    OpenSlotChannels(*slot, channelFactoryInstance));
+            }
+            catch (...)
+            {
+                // Do not hand the same slot to the next connector, the acceptor refills it instead.
+                slot->m_state.store(
+                    detail::AcceptorSlot::MakeState(detail::AcceptorSlot::State::Failed), std::memory_order_release);
+
+                return{};
+            }
+
+            client->NotifySlot(*slot);
+
+            return connection;
+        }
+
+        template <typename I = Input, typename O = Output, std::enable_if_t<!std::is_void<I>::value && !std::is_void<O>::value>* = nullptr>
+        auto OpenSlotChannels(const detail::AcceptorSlot& slot, typename ChannelFactory::Instance& channelFactoryInstance)
+        {
+            // Open in a strict order. Must be the same as the acceptor creates them.
+            auto output = OpenSlotChannels<void, Output>(slot, channelFactoryInstance);
+            auto input = OpenSlotChannels<Input, void>(slot, channelFactoryInstance);
+            return std::tuple_cat(std::move(input), std::move(output));
+        }
+
+        template <typename I = Input, typename O = Output, std::enable_if_t<!std::is_void<I>::value && std::is_void<O>::value>* = nullptr>
+        auto OpenSlotChannels(const detail::AcceptorSlot& slot, typename ChannelFactory::Instance& channelFactoryInstance)
+        {
+            return std::make_tuple(channelFactoryInstance.template OpenInput<Input>(slot.m_connectorChannelName.c_str()));
+        }
+
+        template <typename I = Input, typename O = Output, std::enable_if_t<std::is_void<I>::value && !std::is_void<O>::value>* = nullptr>
+        auto OpenSlotChannels(const detail::AcceptorSlot& slot, typename ChannelFactory::Instance& channelFactoryInstance)
+        {
+            return std::make_tuple(channelFactoryInstance.template OpenOutput<Output>(slot.m_acceptorChannelName.c_str()));
+        }
+
         template <typename O = Output, std::enable_if_t<std::is_void<O>::value>* = nullptr>
         auto BeginConnect(const char* acceptorName)
         {
@@ -345,8 +486,12 @@ namespace IPC
             connectorInfo.m_channelName.assign(detail::GenerateRandomString().c_str());
 
             auto& transaction = std::get<typename ChannelFactory::Instance>(state);
+            auto channel = transaction.template CreateOutput<Output>(connectorInfo.m_channelName.c_str());
+
+            connectorInfo.m_channelMemory = detail::ChannelFactory<void>::InstanceBase::ShareMemory(
+                *channel.GetMemory(), std::get<detail::KernelProcess>(state).GetId());
 
-            return std::tuple_cat(std::move(state), std::make_tuple(transaction.template CreateOutput<Output>(connectorInfo.m_channelName.c_str())));
+            return std::tuple_cat(std::move(state), std::make_tuple(std::move(channel)));
         }
 
         template <typename State, typename Callback, typename... TransactionArgs>
@@ -355,14 +500,25 @@ namespace IPC
             auto client = std::move(std::get<std::shared_ptr<ConnectorClient>>(state)); // Move the client out of the state!
 
             auto connectorInfo = std::move(std::get<detail::ConnectorInfo>(state));
+            auto section = connectorInfo.m_channelMemory;
+            auto processId = std::get<detail::KernelProcess>(state).GetId();
 
-            (*client)(
-                std::move(connectorInfo),
-                [state = std::forward<State>(state), callback = std::forward<Callback>(callback)](detail::AcceptorInfo&& acceptorInfo) mutable
-                {
-                    callback(std::tuple_cat(std::forward<State>(state), std::make_tuple(std::move(acceptorInfo))));
-                },
-                std::forward<TransactionArgs>(transactionArgs)...);
+            try
+            {
+                (*client)(
+                    std::move(connectorInfo),
+                    [state = std::forward<State>(state), callback = std::forward<Callback>(callback)](detail::AcceptorInfo&& acceptorInfo) mutable
+                    {
+                        callback(std::tuple_cat(std::forward<State>(state), std::make_tuple(std::move(acceptorInfo))));
+                    },
+                    std::forward<TransactionArgs>(transactionArgs)...);
+            }
+            catch (...)
+            {
+                // The request was not sent, so the acceptor never takes over the shared section.
+                detail::ChannelFactory<void>::InstanceBase::UnshareMemory(section, processId);
+                throw;
+            }
         }
 
         template <typename State>
@@ -400,8 +556,10 @@ namespace IPC
         template <typename I = Input, typename O = Output, typename State, std::enable_if_t<!std::is_void<I>::value && std::is_void<O>::value>* = nullptr>
         auto CollectChannels(State& state)
         {
+            const auto& acceptorInfo = std::get<detail::AcceptorInfo>(state);
+
             return std::make_tuple(std::get<typename ChannelFactory::Instance>(state).template OpenInput<Input>(
-                std::get<detail::AcceptorInfo>(state).m_channelName.c_str()));
+                acceptorInfo.m_channelName.c_str(), acceptorInfo.m_channelMemory));
         }
 
         template <typename I = Input, typename O = Output, typename State, std::enable_if_t<std::is_void<I>::value && !std::is_void<O>::value>* = nullptr>
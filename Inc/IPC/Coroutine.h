@@ -0,0 +1,206 @@
+#pragma once
+
+#ifdef __cpp_impl_coroutine
+
+#include "detail/Coroutine.h"
+#include "Completion.h"
+#include "Connector.h"
+#include <coroutine>
+#include <memory>
+#include <string>
+#include <future>
+#include <utility>
+#include <type_traits>
+
+
+namespace IPC
+{
+    /// Resumes awaiting coroutines on the thread which completes the operation,
+    /// which is the receiver thread of the connection for calls and connects.
+    struct InlineExecutor
+    {
+        template <typename Function>
+        void operator()(Function&& func) const
+        {
+            std::forward<Function>(func)();
+        }
+    };
+
+
+    /// Awaits the result of Client::Call and resumes through the executor, which is invoked
+    /// with a function that resumes the coroutine. Throws std::future_error when the call
+    /// does not complete with a response.
+    template <typename T, typename Executor>
+    auto ResumeOn(Completion<T>&& completion, Executor executor)
+    {
+        auto start = [completion = std::move(completion)](auto&& callback) mutable
+        {
+            completion.then(std::move(callback));
+        };
+
+        return detail::FutureAwaiter<Completion<T>, decltype(start), Executor>{ std::move(start), std::move(executor) };
+    }
+
+    /// Allows co_await client.Call(request), resuming on the receiver thread.
+    template <typename T>
+    auto operator co_await(Completion<T>&& completion)
+    {
+        return ResumeOn(std::move(completion), InlineExecutor{});
+    }
+
+
+    /// Awaits a connection to the acceptor and resumes through the executor.
+    template <typename Input, typename Output, typename Traits, typename Executor = InlineExecutor>
+    auto AsyncConnect(Connector<Input, Output, Traits>& connector, const char* acceptorName, Executor executor = {})
+    {
+        using Result = std::future<std::unique_ptr<typename Connector<Input, Output, Traits>::Connection>>;
+
+        auto start = [&connector, name = std::string{ acceptorName }](auto&& callback)
+        {
+            connector.Connect(name.c_str(), std::move(callback));
+        };
+
+        return detail::FutureAwaiter<Result, decltype(start), Executor>{ std::move(start), std::move(executor) };
+    }
+
+
+    /// Lazily started coroutine which produces a value when awaited.
+    template <typename T = void>
+    class Task
+    {
+    public:
+        class promise_type : public detail::TaskPromise<T>
+        {
+        public:
+            Task get_return_object() noexcept
+            {
+                return Task{ std::coroutine_handle<promise_type>::from_promise(*this) };
+            }
+        };
+
+        Task(Task&& other) noexcept
+            : m_handle{ std::exchange(other.m_handle, nullptr) }
+        {}
+
+        Task& operator=(Task&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                m_handle = std::exchange(other.m_handle, nullptr);
+            }
+
+            return *this;
+        }
+
+        ~Task()
+        {
+            Reset();
+        }
+
+        auto operator co_await() && noexcept
+        {
+            class Awaiter
+            {
+            public:
+                explicit Awaiter(std::coroutine_handle<promise_type> handle)
+                    : m_handle{ handle }
+                {}
+
+                bool await_ready() const noexcept
+                {
+                    return m_handle.done();
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) const noexcept
+                {
+                    m_handle.promise().SetContinuation(continuation);
+                    return m_handle;
+                }
+
+                T await_resume() const
+                {
+                    return m_handle.promise().GetValue();
+                }
+
+            private:
+                std::coroutine_handle<promise_type> m_handle;
+            };
+
+            return Awaiter{ m_handle };
+        }
+
+    private:
+        explicit Task(std::coroutine_handle<promise_type> handle)
+            : m_handle{ handle }
+        {}
+
+        void Reset()
+        {
+            if (m_handle)
+            {
+                std::exchange(m_handle, nullptr).destroy();
+            }
+        }
+
+
+        std::coroutine_handle<promise_type> m_handle;
+    };
+
+
+    /// Adapts a coroutine handler, which takes the request by value and returns a Task with
+    /// the response, to a Server handler. The response is sent when the task completes and is
+    /// dropped when it throws. Coroutine frames are recycled by a pool owned by the handler,
+    /// so it should be created per connection, e.g. in the handler factory of AcceptServers.
+    /// Only the frames created before the handler first suspends come from the pool, frames
+    /// of tasks started after a resumption are allocated on the heap.
+    template <typename Handler>
+    class CoroutineHandler
+    {
+    public:
+        explicit CoroutineHandler(Handler handler)
+            : m_handler{ std::move(handler) },
+              m_pool{ std::make_shared<detail::CoroutineFramePool>() }
+        {}
+
+        template <typename Request, typename Callback>
+        void operator()(Request&& request, Callback&& callback) const
+        {
+            detail::CoroutineFramePool::Scope scope{ m_pool };
+            Respond(m_handler(std::forward<Request>(request)), std::forward<Callback>(callback));
+        }
+
+        template <typename Request>
+        void operator()(Request&& request) const
+        {
+            detail::CoroutineFramePool::Scope scope{ m_pool };
+            Run(m_handler(std::forward<Request>(request)));
+        }
+
+    private:
+        template <typename T, typename Callback>
+        static detail::DetachedTask Respond(Task<T> task, Callback callback)
+        {
+            callback(co_await std::move(task));
+        }
+
+        static detail::DetachedTask Run(Task<> task)
+        {
+            co_await std::move(task);
+        }
+
+
+        Handler m_handler;
+        std::shared_ptr<detail::CoroutineFramePool> m_pool;
+    };
+
+
+    template <typename Handler>
+    auto MakeCoroutineHandler(Handler&& handler)
+    {
+        return CoroutineHandler<std::decay_t<Handler>>{ std::forward<Handler>(handler) };
+    }
+
+} // IPC
+
+#endif // __cpp_impl_coroutine
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "detail/ChannelBase.h"
+#include "detail/Callback.h"
 #include <memory>
 #include <stdexcept>
+#include <chrono>
+#include <thread>
 
 
 namespace IPC
@@ -18,8 +21,14 @@ namespace IPC
         using ReceiverFactory = typename Traits::ReceiverFactory;
 
     public:
-        InputChannel(create_only_t, const char* name, std::shared_ptr<SharedMemory> memory, WaitHandleFactory waitHandleFactory = {}, ReceiverFactory receiverFactory = {})
-            : InputChannel{ ChannelBase{ create_only, name, std::move(memory) }, std::move(waitHandleFactory), std::move(receiverFactory) }
+        InputChannel(
+            create_only_t,
+            const char* name,
+            std::shared_ptr<SharedMemory> memory,
+            WaitHandleFactory waitHandleFactory = {},
+            ReceiverFactory receiverFactory = {},
+            bool reclaimBuckets = false)
+            : InputChannel{ ChannelBase{ create_only, name, std::move(memory), reclaimBuckets }, std::move(waitHandleFactory), std::move(receiverFactory) }
         {}
 
         InputChannel(open_only_t, const char* name, std::shared_ptr<SharedMemory> memory, WaitHandleFactory waitHandleFactory = {}, ReceiverFactory receiverFactory = {})
@@ -40,17 +49,24 @@ namespace IPC
                 return false;
             }
 
-            m_notEmptyMonitor = m_waitHandleFactory(
-                this->GetNotEmptyEvent(),
-                [this, receiver = m_receiverFactory(this->GetQueue(), std::forward<Handler>(handler))]() mutable
-                {
-                    ConsumeAll(receiver);
-                    return true;
-                });
+            m_notEmptyMonitor = Monitor(m_receiverFactory(this->GetQueue(), std::forward<Handler>(handler)), m_receiverFactory, 0);
 
             return true;
         }
 
+        /// Sets for how long a registered receiver keeps polling the queue after draining it
+        /// before going back to wait for a signal. Senders do not signal while the receiver
+        /// is polling. Zero (default) disables polling. Must be set before RegisterReceiver.
+        void SetSpinDuration(std::chrono::microseconds duration)
+        {
+            m_spinDuration = duration;
+        }
+
+        std::chrono::microseconds GetSpinDuration() const
+        {
+            return m_spinDuration;
+        }
+
         bool UnregisterReceiver()
         {
             if (!m_notEmptyMonitor)
@@ -70,6 +86,49 @@ namespace IPC
               m_receiverFactory{ std::move(receiverFactory) }
         {}
 
+        template <typename Receiver, typename Factory>
+        auto Monitor(Receiver&& receiver, const Factory& /*factory*/, long)
+        {
+            return m_waitHandleFactory(
+                this->GetNotEmptyEvent(),
+                [this, receiver = std::forward<Receiver>(receiver)]() mutable
+                {
+                    if (m_spinDuration == std::chrono::microseconds::zero())
+                    {
+                        ConsumeAll(receiver);
+                    }
+                    else
+                    {
+                        SpinConsumeAll(receiver, m_spinDuration);
+                    }
+
+                    return true;
+                });
+        }
+
+        /// Used for receiver factories which poll the queue themselves, senders never signal while it is monitored.
+        template <typename Receiver, typename Factory,
+            typename = decltype(std::declval<const Factory&>().Poll(std::declval<detail::Callback<std::size_t()>>()))>
+        auto Monitor(Receiver&& receiver, const Factory& factory, int)
+        {
+            this->GetAwakeFlag() = true;
+
+            auto poller = factory.Poll(
+                [this, receiver = std::forward<Receiver>(receiver)]() mutable { return ConsumeAll(receiver); });
+
+            return decltype(poller){ (void*) true, [this, poller](void*) mutable
+                {
+                    poller = {};    // Wait for the polling to stop.
+
+                    this->GetAwakeFlag() = false;
+
+                    if (this->GetCounter() != 0)
+                    {
+                        this->GetNotEmptyEvent().Signal();  // Leave the pending items to the next receiver.
+                    }
+                } };
+        }
+
         template <typename Receiver>
         std::size_t ConsumeAll(Receiver&& receiver)
         {
@@ -90,10 +149,50 @@ namespace IPC
             return 0;
         }
 
+        template <typename Receiver>
+        std::size_t SpinConsumeAll(Receiver&& receiver, std::chrono::microseconds spinDuration)
+        {
+            auto memory = this->GetMemory();    // Make sure memory does not die if receiver deletes this.
+            auto& counter = this->GetCounter();
+            auto& awake = this->GetAwakeFlag();
+            std::size_t count{ 0 };
+
+            awake.store(true);
+
+            for (;;)
+            {
+                for (std::size_t n; counter.load(std::memory_order_relaxed) != 0; counter -= n)
+                {
+                    count += (n = receiver());  // Receiver may delete this.
+                }
+
+                for (auto deadline = std::chrono::steady_clock::now() + spinDuration;
+                    counter.load(std::memory_order_relaxed) == 0 && std::chrono::steady_clock::now() < deadline; )
+                {
+                    std::this_thread::yield();
+                }
+
+                if (counter.load(std::memory_order_relaxed) == 0)
+                {
+                    awake.store(false);
+
+                    if (counter.load() == 0)    // Senders which have seen the flag set did not signal.
+                    {
+                        break;
+                    }
+
+                    awake.store(true);
+                }
+            }
+
+            return count;
+        }
+
         using WaitHandle = decltype(std::declval<WaitHandleFactory>()(
             std::declval<detail::KernelObject>(), std::declval<bool(*)()>()));
 
         WaitHandleFactory m_waitHandleFactory;
+        std::chrono::microseconds m_spinDuration{ 0 };
         WaitHandle m_notEmptyMonitor;
         ReceiverFactory m_receiverFactory;
     };
@@ -3,6 +3,7 @@
 #include "detail/ChannelBase.h"
 #include "Exception.h"
 #include <memory>
+#include <iterator>
 
 
 namespace IPC
@@ -23,7 +24,7 @@ namespace IPC
         {
             if (this->GetQueue().Push(std::forward<U>(value)))
             {
-                if (++this->GetCounter() == 1)
+                if (++this->GetCounter() == 1 && !this->GetAwakeFlag().load())
                 {
                     this->GetNotEmptyEvent().Signal();
                 }
@@ -42,6 +43,40 @@ namespace IPC
                 throw Exception{ "Out of buffers." };
             }
         }
+
+        /// Sends a prefix of the range that fits into the queue, updating the shared
+        /// counter and signaling the receiver at most once for the whole batch.
+        /// Returns the number of sent elements. Use move iterators to move them out.
+        template <typename Iterator>
+        std::size_t TrySendRange(Iterator first, Iterator last)
+        {
+            auto count = this->GetQueue().Push(first, last);
+
+            if (count != 0 && this->GetCounter().fetch_add(count) == 0 && !this->GetAwakeFlag().load())
+            {
+                this->GetNotEmptyEvent().Signal();
+            }
+
+            return count;
+        }
+
+        /// Sends the whole range or throws when it does not fit into the queue.
+        /// Elements preceding the first rejected one are sent regardless.
+        template <typename Iterator>
+        void SendBatch(Iterator first, Iterator last)
+        {
+            while (first != last)
+            {
+                auto count = TrySendRange(first, last);     // Rethrows element errors once nothing else can be sent.
+
+                if (count == 0)
+                {
+                    throw Exception{ "Out of buffers." };
+                }
+
+                std::advance(first, count);
+            }
+        }
     };
 
 } // IPC
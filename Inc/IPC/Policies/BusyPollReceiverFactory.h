@@ -0,0 +1,52 @@
+#pragma once
+
+#include "IPC/detail/Callback.h"
+#include <memory>
+#include <chrono>
+#include <cstdint>
+
+
+namespace IPC
+{
+namespace Policies
+{
+    /// Drains registered input channels from a dedicated thread which continuously polls
+    /// them instead of waiting on kernel events. All copies of a factory share the same
+    /// thread, which is started on first registration and stopped when the factory and
+    /// all receivers are destroyed. Must be used directly as Traits::ReceiverFactory.
+    class BusyPollReceiverFactory
+    {
+    public:
+        /// Controls how the polling thread backs off when none of the channels has data.
+        struct Backoff
+        {
+            std::uint32_t m_spinCount{ 4096 };                  // Idle passes with a processor pause.
+            std::uint32_t m_yieldCount{ 1024 };                 // Following idle passes which yield the processor.
+            std::chrono::microseconds m_sleepDuration{ 0 };     // Sleep afterwards, zero keeps yielding.
+        };
+
+        BusyPollReceiverFactory();
+
+        /// The affinityMask pins the polling thread to the given processors, zero leaves it unpinned.
+        explicit BusyPollReceiverFactory(std::uint64_t affinityMask);
+
+        BusyPollReceiverFactory(std::uint64_t affinityMask, Backoff backoff);
+
+        template <typename Queue, typename Handler>
+        auto operator()(Queue& queue, Handler&& handler) const
+        {
+            return [&queue, handler = std::forward<Handler>(handler)]() mutable { return queue.ConsumeAll(handler); };
+        }
+
+        /// Invokes the function from the polling thread until the returned handle is destroyed.
+        /// The function returns the number of processed items which drives the backoff.
+        std::shared_ptr<void> Poll(detail::Callback<std::size_t()> func) const;
+
+    private:
+        class Impl;
+
+        std::shared_ptr<Impl> m_impl;
+    };
+
+} // Policies
+} // IPC
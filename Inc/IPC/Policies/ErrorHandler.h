@@ -2,6 +2,7 @@
 
 #include <exception>
 #include <iostream>
+#include <cstddef>
 
 
 namespace IPC
@@ -15,7 +16,12 @@ namespace Policies
 
         void operator()(std::exception_ptr error) const;
 
+        /// Reports a failed reconnection, the attempt is the number of consecutive failures.
+        void operator()(std::exception_ptr error, std::size_t attempt) const;
+
     private:
+        void Write(std::exception_ptr error) const;
+
         std::ostream& m_stream;
     };
 
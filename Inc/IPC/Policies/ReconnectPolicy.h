@@ -0,0 +1,38 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+
+namespace IPC
+{
+namespace Policies
+{
+    class ReconnectPolicy
+    {
+    public:
+        /// Retries after the default timeout of the TimeoutFactory, without backoff.
+        ReconnectPolicy() = default;
+
+        /// Retries after initialDelay which grows by multiplier with every consecutive failed attempt
+        /// up to maxDelay. Each delay is randomly shortened by up to the jitter fraction of it, so that
+        /// clients which lost the same server do not retry in lockstep.
+        ReconnectPolicy(
+            const std::chrono::milliseconds& initialDelay,
+            const std::chrono::milliseconds& maxDelay,
+            double multiplier = 2.0,
+            double jitter = 0.5);
+
+        /// Returns the delay before the next attempt after the given number of consecutive failures.
+        /// Zero means the default timeout of the TimeoutFactory.
+        std::chrono::milliseconds operator()(std::size_t failures) const;
+
+    private:
+        std::chrono::milliseconds m_initialDelay{ std::chrono::milliseconds::zero() };
+        std::chrono::milliseconds m_maxDelay{ std::chrono::milliseconds::zero() };
+        double m_multiplier{ 1.0 };
+        double m_jitter{ 0.0 };
+    };
+
+} // Policies
+} // IPC
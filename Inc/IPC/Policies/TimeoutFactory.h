@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ThreadPool.h"
+#include "ReconnectPolicy.h"
 #include "IPC/detail/Callback.h"
 #include <memory>
 #include <chrono>
@@ -42,13 +43,21 @@ namespace Policies
         };
 
     public:
-        TimeoutFactory(const std::chrono::milliseconds& defaultTimeout = std::chrono::milliseconds::zero(), boost::optional<ThreadPool> pool = {});
+        /// The reconnectPolicy is used by ConnectClient and ConnectServer to delay the attempts
+        /// after failed ones, see ReconnectPolicy.
+        TimeoutFactory(
+            const std::chrono::milliseconds& defaultTimeout = std::chrono::milliseconds::zero(),
+            boost::optional<ThreadPool> pool = {},
+            ReconnectPolicy reconnectPolicy = {});
 
         Scheduler operator()(detail::Callback<void()> handler) const;
 
+        const ReconnectPolicy& GetReconnectPolicy() const;
+
     private:
         std::chrono::milliseconds m_defaultTimeout;
         boost::optional<ThreadPool> m_pool;
+        ReconnectPolicy m_reconnectPolicy;
     };
 
 } // Policies
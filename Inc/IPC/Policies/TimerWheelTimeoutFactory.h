@@ -0,0 +1,65 @@
+#pragma once
+
+#include "IPC/detail/Callback.h"
+#include "ReconnectPolicy.h"
+#include <memory>
+#include <chrono>
+#include <cstddef>
+
+
+namespace IPC
+{
+namespace Policies
+{
+    /// Drop-in replacement of TimeoutFactory which keeps all timeouts in a hierarchical timing
+    /// wheel driven by a single thread instead of a thread pool timer per scheduler. Scheduling
+    /// and deactivation take constant time and never touch the kernel. Timeouts are rounded up
+    /// to the tick and may fire up to one tick late. All factories with the same tick share the
+    /// same wheel and handlers are invoked one at a time from its thread, so they must be short.
+    class TimerWheelTimeoutFactory
+    {
+        class Wheel;
+        class Timer;
+
+        class Scheduler
+        {
+        public:
+            explicit Scheduler(std::shared_ptr<Timer> timer);
+
+            ~Scheduler();
+
+            /// Schedules a timeout to fire after predefined amount of time configured in TimerWheelTimeoutFactory.
+            /// Previously scheduled timeout is deactivated first.
+            void operator()() const;
+
+            /// Schedules a timeout to fire after specified amount of time.
+            /// Previously scheduled timeout is deactivated first.
+            void operator()(const std::chrono::milliseconds& timeout) const;
+
+            /// Deactivates already scheduled timeout.
+            /// Blocks until the running handler (if any) returns.
+            void operator()(std::nullptr_t) const;
+
+        private:
+            std::shared_ptr<Timer> m_timer;
+        };
+
+    public:
+        /// The reconnectPolicy is used by ConnectClient and ConnectServer, see TimeoutFactory.
+        TimerWheelTimeoutFactory(
+            const std::chrono::milliseconds& defaultTimeout = std::chrono::milliseconds::zero(),
+            const std::chrono::milliseconds& tick = std::chrono::milliseconds{ 1 },
+            ReconnectPolicy reconnectPolicy = {});
+
+        Scheduler operator()(detail::Callback<void()> handler) const;
+
+        const ReconnectPolicy& GetReconnectPolicy() const;
+
+    private:
+        std::chrono::milliseconds m_defaultTimeout;
+        std::shared_ptr<Wheel> m_wheel;
+        ReconnectPolicy m_reconnectPolicy;
+    };
+
+} // Policies
+} // IPC
@@ -15,6 +15,9 @@ namespace IPC
 {
 namespace Policies
 {
+    /// Tracks outstanding requests. Ids carry a generation of the pooled transaction, so
+    /// ending a transaction with the id of an earlier use of the same slot, e.g. for a late
+    /// response to a timed out request, is rejected.
     template <typename Context, typename TimeoutFactory>
     class TransactionManager
     {
@@ -32,9 +35,9 @@ namespace Policies
         Id BeginTransaction(OtherContext&& context, const std::chrono::milliseconds& timeout = std::chrono::milliseconds::zero())
         {
             auto result = m_transactions->Take(
-                [this](Id id)
+                [this](Transaction& transaction)
                 {
-                    return m_timeoutFactory([this, id] { EndTransaction(id); });
+                    return m_timeoutFactory([this, &transaction] { EndTransaction(transaction.GetId()); });
                 });
 
             Transaction& transaction = result.first;
@@ -42,7 +45,7 @@ namespace Policies
 
             try
             {
-                transaction.Begin(std::forward<OtherContext>(context), NonZeroTimeout(timeout, m_defaultTimeout));
+                transaction.Begin(id, std::forward<OtherContext>(context), NonZeroTimeout(timeout, m_defaultTimeout));
             }
             catch (...)
             {
@@ -77,18 +80,25 @@ namespace Policies
         {
         public:
             template <typename SchedulerFactory>
-            Transaction(Id id, SchedulerFactory&& schedulerFactory)
-                : m_timeoutScheduler{ std::forward<SchedulerFactory>(schedulerFactory)(id) }
+            Transaction(Id /*index*/, SchedulerFactory&& schedulerFactory)
+                : m_timeoutScheduler{ std::forward<SchedulerFactory>(schedulerFactory)(*this) }
             {}
 
             template <typename OtherContext>
-            void Begin(OtherContext&& context, const std::chrono::milliseconds& timeout)
+            void Begin(Id id, OtherContext&& context, const std::chrono::milliseconds& timeout)
             {
                 assert(timeout != std::chrono::milliseconds::zero());
+                m_id = id;
                 m_context = std::forward<OtherContext>(context);
                 m_timeoutScheduler(timeout);
             }
 
+            /// Returns the id of the current use. Only changes while the timeout is not scheduled.
+            Id GetId() const
+            {
+                return m_id;
+            }
+
             boost::optional<Context> End()
             {
                 m_timeoutScheduler(nullptr);    // This must wait for callback (which effectively runs End) to complete.
@@ -101,11 +111,14 @@ namespace Policies
         private:
             using TimeoutScheduler = decltype(std::declval<TimeoutFactory>()({}));
 
+            Id m_id{ 0 };
             boost::optional<Context> m_context;
             TimeoutScheduler m_timeoutScheduler;
         };
 
-        using TransactionPool = detail::LockFree::IndexedObjectPool<Transaction, std::allocator<void>>;
+        /// Leaves 20 bits for up to 1M outstanding transactions. Free transactions are reused
+        /// most recently returned first, so the generation is kept as wide as possible.
+        using TransactionPool = detail::LockFree::IndexedObjectPool<Transaction, std::allocator<void>, 64, 12>;
 
         static_assert(std::is_same<Id, typename TransactionPool::Index>::value, "Id and Index must have the same type.");
 
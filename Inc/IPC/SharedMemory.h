@@ -2,17 +2,25 @@
 
 #pragma warning(push)
 #pragma warning(disable : 4459)
-#include <boost/interprocess/managed_windows_shared_memory.hpp>
+#include <boost/interprocess/managed_external_buffer.hpp>
 #include <boost/interprocess/smart_ptr/unique_ptr.hpp>
 #include <boost/interprocess/smart_ptr/shared_ptr.hpp>
 #include <boost/interprocess/smart_ptr/weak_ptr.hpp>
 #pragma warning(pop)
 
 #include "detail/Alias.h"
+#include "detail/SizeClassBestFit.h"
+#include "detail/SelectableIndex.h"
 #include "detail/SpinLock.h"
 #include "detail/RecursiveSpinLock.h"
+#include "detail/KernelObject.h"
 #include "Exception.h"
 #include <string>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <array>
+#include <cstdint>
 #include <type_traits>
 
 
@@ -26,12 +34,55 @@ namespace IPC
             using recursive_mutex_type = detail::RecursiveSpinLock;
         };
 
-        using ManagedSharedMemory = detail::ipc::basic_managed_windows_shared_memory<
-            char, detail::ipc::rbtree_best_fit<MutexFamily>, detail::ipc::iset_index>;
+        using MemoryAlgorithm = detail::SizeClassBestFit<MutexFamily>;
+
+        /// Placed into a section mapped by SharedMemory itself, since boost can only map sections by name.
+        using ManagedSharedMemory = detail::ipc::basic_managed_external_buffer<
+            char, MemoryAlgorithm, detail::SelectableIndex>;
 
     public:
         using Handle = ManagedSharedMemory::handle_t;
 
+        /// Options applied when a shared memory segment is created.
+        struct Options
+        {
+            bool m_sizeClasses{ false };    // Reuse small blocks through lock-free size class lists, see detail::SizeClassBestFit.
+            bool m_threadCaches{ false };   // Serve small Allocator blocks from per-thread caches, implies m_sizeClasses.
+            bool m_largePages{ false };     // Back the memory with large pages when the account holds SeLockMemoryPrivilege, see HasLargePages.
+            bool m_prefault{ false };       // Touch all pages on creation, see Prefault.
+            bool m_lockPages{ false };      // Also lock all pages in memory on creation, implies m_prefault.
+            bool m_hashedIndex{ false };    // Look up named objects in a hash table instead of a tree, see detail::SelectableIndex.
+            std::size_t m_maxSize{ 0 };     // Reserve address space up to this size and grow into it when allocations fail, zero disables growth.
+        };
+
+        /// Time spent setting up the memory in this process.
+        struct Timings
+        {
+            std::chrono::microseconds m_map{ 0 };       // Creating or opening the memory and mapping it.
+            std::chrono::microseconds m_prefault{ 0 };  // Touching all pages.
+            std::chrono::microseconds m_lock{ 0 };      // Locking all pages in memory.
+        };
+
+        /// Snapshot of the memory usage. All sizes are in bytes and include block headers.
+        struct Statistics
+        {
+            std::size_t m_size{ 0 };                // Usable size, see GetSize.
+            std::size_t m_usedSize{ 0 };            // Allocated blocks, including the ones in thread caches.
+            std::size_t m_cachedSize{ 0 };          // Freed blocks kept in size class lists, see Options::m_sizeClasses.
+            std::size_t m_freeSize{ 0 };            // Free blocks available to any allocation.
+            std::size_t m_largestFreeBlock{ 0 };
+            std::size_t m_highWaterMark{ 0 };       // Maximum of m_usedSize + m_cachedSize since creation, approximate.
+            std::size_t m_namedObjects{ 0 };
+            std::size_t m_uniqueObjects{ 0 };       // Constructed with unique_instance. Anonymous objects are not indexed and only count in m_usedSize.
+
+            /// Number of free blocks by size: [0] below 128 bytes, [i] in [64 << i, 128 << i) and
+            /// the last one also counts all larger blocks.
+            std::array<std::size_t, 16> m_freeBlocks{};
+        };
+
+        /// When the memory is created with Options::m_threadCaches, small blocks are allocated from
+        /// and freed to a cache owned by the calling thread which exchanges them with the shared
+        /// size class lists in batches. Blocks may be freed by any thread of any process.
         template <typename T>
         class Allocator : public ManagedSharedMemory::allocator<T>::type
         {
@@ -44,14 +95,87 @@ namespace IPC
                 using other = Allocator<U>;
             };
 
+            using typename Base::pointer;
+            using typename Base::size_type;
+
             using Base::Base;
 
             using Base::construct;
 
-            void construct(const typename Base::pointer& ptr, const boost::container::default_init_t&)
+            void construct(const pointer& ptr, const boost::container::default_init_t&)
             {
                 ::new (static_cast<void*>(boost::interprocess::ipcdetail::to_raw_pointer(ptr)), boost_container_new_t()) typename Base::value_type;
             }
+
+            pointer allocate(size_type count)
+            {
+                auto& algorithm = GetMemoryAlgorithm(*this->get_segment_manager());
+
+                if (algorithm.IsThreadCachingEnabled() && count <= MemoryAlgorithm::c_maxClassSize / sizeof(T))
+                {
+                    if (auto ptr = AllocateCached(algorithm, count * sizeof(T)))
+                    {
+                        return pointer{ static_cast<T*>(ptr) };
+                    }
+
+                    throw detail::ipc::bad_alloc{};
+                }
+
+                return Base::allocate(count);
+            }
+
+            void deallocate(const pointer& ptr, size_type count)
+            {
+                auto& algorithm = GetMemoryAlgorithm(*this->get_segment_manager());
+                auto raw = boost::interprocess::ipcdetail::to_raw_pointer(ptr);
+
+                if (!algorithm.IsThreadCachingEnabled() || !raw || !DeallocateCached(algorithm, raw))
+                {
+                    Base::deallocate(ptr, count);
+                }
+            }
+
+            pointer allocate_one()
+            {
+                return allocate(1);
+            }
+
+            void deallocate_one(const pointer& ptr)
+            {
+                deallocate(ptr, 1);
+            }
+
+            /// Used by containers. New small allocations are routed through allocate so that they
+            /// are served by the size classes, expansion of existing blocks goes to the base.
+            pointer allocation_command(
+                detail::ipc::allocation_type command, size_type limitSize, size_type& preferInRecvdOutSize, pointer& reuse)
+            {
+                if ((command & detail::ipc::allocate_new)
+                    && (!reuse || !(command & (detail::ipc::expand_fwd | detail::ipc::expand_bwd)))
+                    && preferInRecvdOutSize <= MemoryAlgorithm::c_maxClassSize / sizeof(T)
+                    && GetMemoryAlgorithm(*this->get_segment_manager()).IsSizeClassesEnabled())
+                {
+                    try
+                    {
+                        auto ptr = allocate((std::max)(limitSize, preferInRecvdOutSize));
+                        preferInRecvdOutSize = (std::max)(limitSize, preferInRecvdOutSize);
+                        reuse = nullptr;
+                        return ptr;
+                    }
+                    catch (const detail::ipc::bad_alloc&)
+                    {
+                        if (!(command & detail::ipc::nothrow_allocation))
+                        {
+                            throw;
+                        }
+
+                        reuse = nullptr;
+                        return nullptr;
+                    }
+                }
+
+                return Base::allocation_command(command, limitSize, preferInRecvdOutSize, reuse);
+            }
         };
 
         template <typename T>
@@ -66,15 +190,24 @@ namespace IPC
         template <typename T>
         using WeakPtr = typename detail::ipc::managed_weak_ptr<T, ManagedSharedMemory>::type;
 
+        /// A null name creates an anonymous memory which can only be opened by other processes through Share.
         SharedMemory(create_only_t, const char* name, std::size_t size);
 
+        SharedMemory(create_only_t, const char* name, std::size_t size, const Options& options);
+
         SharedMemory(open_only_t, const char* name);
 
+        /// Opens the memory from a section handle returned by Share and takes its ownership.
+        SharedMemory(open_only_t, std::uint64_t section);
+
         SharedMemory(const SharedMemory& other) = delete;
         SharedMemory& operator=(const SharedMemory& other) = delete;
 
         SharedMemory(SharedMemory&& other) = default;
-        SharedMemory& operator=(SharedMemory&& other) = default;
+        SharedMemory& operator=(SharedMemory&& other);
+
+        /// Returns the blocks cached by all threads of this process back to the memory.
+        ~SharedMemory();
 
         template <typename T>
         Allocator<T> GetAllocator()
@@ -175,10 +308,46 @@ namespace IPC
 
         bool Contains(const void* ptr) const;
 
+        /// Returns an empty name for anonymous memory.
         const std::string& GetName() const;
 
+        /// Duplicates the section handle into the given process and returns its value there, so that
+        /// the process can open the memory without a name lookup. The handle is owned by that process
+        /// and stays open there until it is passed to the open_only constructor.
+        std::uint64_t Share(std::uint32_t processId) const;
+
+        /// Closes a section handle returned by Share in the given process, for when the process
+        /// never learns about it because the handshake failed. Zero handles are ignored.
+        static void Unshare(std::uint64_t section, std::uint32_t processId) noexcept;
+
         std::size_t GetFreeSize() const;
 
+        /// Returns the currently usable size which grows up to GetMaxSize when the memory is
+        /// created with Options::m_maxSize.
+        std::size_t GetSize() const;
+
+        std::size_t GetMaxSize() const;
+
+        /// Returns true if the memory is backed by large pages. Can be false even when requested
+        /// with Options::m_largePages, since regular pages are used if large ones are unavailable.
+        /// SeLockMemoryPrivilege is enabled in the process token only while the memory is created
+        /// and then restored to its previous state.
+        bool HasLargePages() const;
+
+        /// Touches every page so that first accesses from this process do not fault. Safe to call
+        /// while the memory is in use. If lockPages is true also keeps the pages resident for as
+        /// long as the memory is mapped and returns false if they could not be locked. Pages already
+        /// touched through this object are skipped, so only a first call or growth since costs a walk.
+        bool Prefault(bool lockPages = false);
+
+        bool IsLocked() const;
+
+        const Timings& GetTimings() const;
+
+        /// Collects the statistics while holding the allocator lock only for a walk over the
+        /// free blocks. Safe to call while the memory is in use by any process.
+        Statistics GetStatistics() const;
+
         static std::size_t GetMinSize();
 
     private:
@@ -188,8 +357,55 @@ namespace IPC
             || std::is_same<std::decay_t<Name>, decltype(anonymous_instance)>::value
             || std::is_same<std::decay_t<Name>, decltype(unique_instance)>::value>;
 
-        ManagedSharedMemory m_memory;
+        class ThreadCache;
+
+        /// Section and its view in this process. The managed memory follows the header of
+        /// managed_windows_shared_memory, so the layout is the same as when boost creates it.
+        struct Mapping
+        {
+            detail::KernelObject m_section;
+            std::shared_ptr<void> m_view;
+        };
+
+        static Mapping CreateMapping(const char* name, std::size_t size, const Options& options);
+
+        static Mapping CreateLargePageMapping(const char* name, std::size_t size, const Options& options);
+
+        static Mapping CreateGrowableMapping(const char* name, std::size_t size, std::size_t maxSize, const Options& options);
+
+        /// Applies the segment modes of the options before the segment is marked initialized,
+        /// since peers may open a named section as soon as it is.
+        static Mapping CreateSectionMapping(const char* name, std::size_t size, std::size_t maxSize, std::uint32_t flags, const Options& options);
+
+        static Mapping OpenMapping(const char* name);
+
+        static Mapping OpenSectionMapping(detail::KernelObject section);
+
+        static ManagedSharedMemory OpenMemory(const Mapping& mapping);
+
+        static std::size_t GetHeaderSize();
+
+        static MemoryAlgorithm& GetMemoryAlgorithm(ManagedSharedMemory::segment_manager& manager)
+        {
+            // The memory algorithm is a private base of the segment manager.
+            return (MemoryAlgorithm&)manager;
+        }
+
+        static void* AllocateCached(MemoryAlgorithm& algorithm, std::size_t size);
+
+        static bool DeallocateCached(MemoryAlgorithm& algorithm, void* ptr);
+
+        void ReleaseThreadCaches();
+
+
+        Timings m_timings;
+        std::shared_ptr<void> m_pageLock;   // Returns the working set quota used for locking when released. Must be declared before m_mapping.
+        Mapping m_mapping;
+        ManagedSharedMemory m_memory;   // Must be declared after m_mapping.
         std::string m_name;
+        bool m_largePages;
+        std::size_t m_prefaultedSize{ 0 };  // Offset of the first page not touched yet by Prefault.
+        std::unique_ptr<std::mutex> m_prefaultLock{ std::make_unique<std::mutex>() };    // Channels sharing a cached memory may prefault it concurrently.
     };
 
 } // IPC
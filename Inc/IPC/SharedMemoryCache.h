@@ -1,24 +1,52 @@
 #pragma once
 
+#include "SharedMemory.h"
 #include <memory>
+#include <chrono>
+#include <cstdint>
 
 
 namespace IPC
 {
-    class SharedMemory;
-
-
     class SharedMemoryCache
     {
     public:
+        /// Keeps the most recently opened memories mapped after their last user releases them,
+        /// so that opening them again does not map and fault in the pages again. A kept memory
+        /// also keeps its name in use, so a creator restarting while it is kept fails to create
+        /// it again, see Clear. Expired memories are released by the following Create, Open or
+        /// GetStatistics call.
+        struct Options
+        {
+            std::size_t m_capacity{ 0 };            // Maximum number of kept memories, zero disables keeping.
+            std::chrono::milliseconds m_ttl{ 0 };   // Time since the last Open after which a memory is released, zero for no limit.
+        };
+
+        /// Statistics summed over all memories alive in the cache, see SharedMemory::Statistics.
+        struct Statistics
+        {
+            std::size_t m_memoryCount{ 0 };
+            std::size_t m_keptCount{ 0 };       // Memories kept mapped, see Options.
+            std::uint64_t m_hitCount{ 0 };      // Open calls returning an already mapped memory.
+            std::uint64_t m_missCount{ 0 };     // Open calls mapping the memory.
+            SharedMemory::Statistics m_total;   // m_largestFreeBlock is the maximum instead of the sum.
+        };
+
         SharedMemoryCache();
 
+        explicit SharedMemoryCache(const Options& options);
+
         ~SharedMemoryCache();
 
-        std::shared_ptr<SharedMemory> Create(const char* name, std::size_t size);
+        std::shared_ptr<SharedMemory> Create(const char* name, std::size_t size, const SharedMemory::Options& options = {});
 
         std::shared_ptr<SharedMemory> Open(const char* name);
 
+        Statistics GetStatistics() const;
+
+        /// Releases all kept memories.
+        void Clear();
+
     private:
         class Impl;
 
@@ -4,8 +4,10 @@
 #include "Accept.h"
 #include "Connector.h"
 #include "Connect.h"
+#include "ClientPool.h"
 #include <memory>
 #include <mutex>
+#include <vector>
 
 
 namespace IPC
@@ -23,6 +25,7 @@ namespace IPC
         using ServerConnector = ServerConnector<Request, Response, Traits>;
         using ClientAcceptor = ClientAcceptor<Request, Response, Traits>;
         using ServerAcceptor = ServerAcceptor<Request, Response, Traits>;
+        using ClientPool = ClientPool<Request, Response, Traits>;
 
         Transport()
             : Transport{ {} }
@@ -70,18 +73,9 @@ namespace IPC
             std::shared_ptr<ClientConnector> connector = {},
             TransactionArgs&&... transactionArgs)
         {
-            if (!connector)
-            {
-                std::call_once(
-                    m_clientConnectorOnceFlag,
-                    [this] { m_clientConnector = std::make_shared<ClientConnector>(MakeClientConnector()); });
-
-                connector = m_clientConnector;
-            }
-
             return IPC::ConnectClient(
                 name,
-                connector,
+                GetClientConnector(std::move(connector)),
                 async,
                 m_timeoutFactory,
                 m_errorHandler,
@@ -89,6 +83,36 @@ namespace IPC
                 std::forward<TransactionArgs>(transactionArgs)...);
         }
 
+        /// Connects the given number of clients to the same acceptor, each reconnecting independently.
+        template <typename... TransactionArgs>
+        auto ConnectClientPool(
+            const char* name,
+            std::size_t size,
+            typename ClientPool::Balancing balancing,
+            bool async,
+            std::shared_ptr<ClientConnector> connector = {},
+            const TransactionArgs&... transactionArgs)
+        {
+            connector = GetClientConnector(std::move(connector));
+
+            std::vector<typename ClientPool::Accessor> accessors;
+            accessors.reserve(size);
+
+            for (std::size_t i = 0; i != size; ++i)
+            {
+                accessors.push_back(IPC::ConnectClient(
+                    name,
+                    connector,
+                    async,
+                    m_timeoutFactory,
+                    m_errorHandler,
+                    m_transactionManagerFactory,
+                    transactionArgs...));
+            }
+
+            return ClientPool{ std::move(accessors), balancing };
+        }
+
         template <typename HandlerFactory, typename... TransactionArgs>
         auto ConnectServer(
             const char* name,
@@ -130,6 +154,20 @@ namespace IPC
         }
 
     private:
+        std::shared_ptr<ClientConnector> GetClientConnector(std::shared_ptr<ClientConnector> connector)
+        {
+            if (!connector)
+            {
+                std::call_once(
+                    m_clientConnectorOnceFlag,
+                    [this] { m_clientConnector = std::make_shared<ClientConnector>(MakeClientConnector()); });
+
+                connector = m_clientConnector;
+            }
+
+            return connector;
+        }
+
         ChannelSettings<Traits> m_channelSettings;
         std::size_t m_hostInfoMemorySize;
         typename Traits::TimeoutFactory m_timeoutFactory;
@@ -1,10 +1,9 @@
 #pragma once
 
-#pragma warning(push)
-#include <boost/function.hpp>
-#pragma warning(pop)
-
 #include <type_traits>
+#include <utility>
+#include <new>
+#include <cstddef>
 #include <cassert>
 
 
@@ -12,79 +11,180 @@ namespace IPC
 {
     namespace detail
     {
-        template <typename Function>
-        class CopyableFunction
-        {
-        public:
-            explicit CopyableFunction(Function&& func)
-                : m_func{ std::move(func) }
-            {}
+        template <typename Function, std::size_t BufferSize = 64>
+        class Callback;
 
-            CopyableFunction(const CopyableFunction& other)
-                : CopyableFunction{ std::move(const_cast<CopyableFunction&>(other)) }
-            {}
 
-            CopyableFunction(CopyableFunction&& other) = default;
+        /// Move-only function wrapper. Functions of up to BufferSize bytes which can be moved without
+        /// throwing are stored inline, so constructing, moving and invoking the callback does not
+        /// allocate. Larger functions are kept on the heap.
+        template <typename Result, typename... Args, std::size_t BufferSize>
+        class Callback<Result(Args...), BufferSize>
+        {
+            using Storage = std::aligned_storage_t<BufferSize>;
 
-            template <typename... Args>
-            decltype(auto) operator()(Args&&... args)
+            struct Operations
             {
-                return m_func(std::forward<Args>(args)...);
-            }
-
-            template <typename... Args>
-            decltype(auto) operator()(Args&&... args) const
+                Result (*m_invoke)(void* func, Args&&... args);
+                void (*m_move)(void* from, void* to);           // Constructs at the destination and destroys the source.
+                void (*m_destroy)(void* func);
+            };
+
+            template <typename Function>
+            using IsInline = std::integral_constant<bool,
+                sizeof(Function) <= sizeof(Storage)
+                && alignof(Function) <= alignof(Storage)
+                && std::is_nothrow_move_constructible<Function>::value>;
+
+            template <typename Function, bool = IsInline<Function>::value>
+            struct Inline
             {
-                return m_func(std::forward<Args>(args)...);
-            }
-
-        private:
-            Function m_func;
-        };
-
-
-        template <typename Function>
-        class Callback;
-
+                static Function& Get(void* storage)
+                {
+                    return *static_cast<Function*>(storage);
+                }
+
+                template <typename Other>
+                static void Create(void* storage, Other&& func)
+                {
+                    new (storage) Function(std::forward<Other>(func));
+                }
+
+                static void Move(void* from, void* to)
+                {
+                    new (to) Function(std::move(Get(from)));
+                    Get(from).~Function();
+                }
+
+                static void Destroy(void* storage)
+                {
+                    Get(storage).~Function();
+                }
+            };
+
+            template <typename Function>
+            struct Inline<Function, false>
+            {
+                static Function& Get(void* storage)
+                {
+                    return **static_cast<Function**>(storage);
+                }
+
+                template <typename Other>
+                static void Create(void* storage, Other&& func)
+                {
+                    new (storage) Function*{ new Function(std::forward<Other>(func)) };
+                }
+
+                static void Move(void* from, void* to)
+                {
+                    new (to) Function*{ *static_cast<Function**>(from) };
+                }
+
+                static void Destroy(void* storage)
+                {
+                    delete *static_cast<Function**>(storage);
+                }
+            };
+
+            template <typename Function>
+            struct Handler : Inline<Function>
+            {
+                static Result Invoke(void* storage, Args&&... args)
+                {
+                    return static_cast<Result>(Handler::Get(storage)(std::forward<Args>(args)...));
+                }
+
+                static const Operations* GetOperations()
+                {
+                    static constexpr Operations operations{ &Handler::Invoke, &Handler::Move, &Handler::Destroy };
+                    return &operations;
+                }
+            };
 
-        template <typename Result, typename... Args>
-        class Callback<Result(Args...)>
-        {
         public:
             Callback() = default;
 
-            template <typename Function, typename = std::enable_if_t<!std::is_base_of<Callback, std::remove_reference_t<Function>>::value>,
-                std::enable_if_t<!std::is_copy_constructible<std::decay_t<Function>>::value>* = nullptr>
-            Callback(Function&& func)
-                : m_func{ CopyableFunction<std::decay_t<Function>>{ std::forward<Function>(func) } }
-            {}
-
-            template <typename Function, typename = std::enable_if_t<!std::is_base_of<Callback, std::remove_reference_t<Function>>::value>,
-                std::enable_if_t<std::is_copy_constructible<std::decay_t<Function>>::value>* = nullptr>
+            template <typename Function, typename = std::enable_if_t<!std::is_base_of<Callback, std::decay_t<Function>>::value>>
             Callback(Function&& func)
-                : m_func{ std::forward<Function>(func) }
-            {}
+            {
+                if (!IsNull(func))
+                {
+                    Handler<std::decay_t<Function>>::Create(&m_storage, std::forward<Function>(func));
+                    m_operations = Handler<std::decay_t<Function>>::GetOperations();
+                }
+            }
 
             Callback(const Callback& other) = delete;
             Callback& operator=(const Callback& other) = delete;
 
-            Callback(Callback&& other) = default;
-            Callback& operator=(Callback&& other) = default;
+            Callback(Callback&& other) noexcept
+            {
+                MoveFrom(other);
+            }
+
+            Callback& operator=(Callback&& other) noexcept
+            {
+                if (this != &other)
+                {
+                    Reset();
+                    MoveFrom(other);
+                }
+
+                return *this;
+            }
+
+            ~Callback()
+            {
+                Reset();
+            }
 
             explicit operator bool() const
             {
-                return static_cast<bool>(m_func);
+                return m_operations != nullptr;
             }
 
-            template <typename... OtherArgs>
-            decltype(auto) operator()(OtherArgs&&... args) const
+            Result operator()(Args... args) const
             {
-                assert(m_func);
-                return m_func(std::forward<OtherArgs>(args)...);
+                assert(m_operations);
+                return m_operations->m_invoke(&m_storage, std::forward<Args>(args)...);
             }
 
         private:
-            boost::function<Result(Args...)> m_func;    // TODO: Use std::function when bugs are fixed in VC14 (capturing nested polymorphic lambdas fails).
+            template <typename Function>
+            static bool IsNull(const Function& /*func*/)
+            {
+                return false;
+            }
+
+            template <typename Function>
+            static bool IsNull(Function* func)
+            {
+                return func == nullptr;
+            }
+
+            void MoveFrom(Callback& other)
+            {
+                if (other.m_operations)
+                {
+                    other.m_operations->m_move(&other.m_storage, &m_storage);
+                    m_operations = other.m_operations;
+                    other.m_operations = nullptr;
+                }
+            }
+
+            void Reset()
+            {
+                if (auto operations = m_operations)
+                {
+                    m_operations = nullptr;
+                    operations->m_destroy(&m_storage);
+                }
+            }
+
+
+            const Operations* m_operations{ nullptr };
+            mutable Storage m_storage;     // Invoking a const callback may change the state of the stored function.
         };
 
     } // detail
@@ -10,6 +10,7 @@
 #include <typeinfo>
 #include <memory>
 #include <atomic>
+#include <type_traits>
 
 #pragma warning(push)
 #include <boost/interprocess/containers/string.hpp>
@@ -44,9 +45,11 @@ namespace IPC
         class ChannelBase
         {
         public:
-            ChannelBase(create_only_t, const char* name, std::shared_ptr<SharedMemory> memory)
+            /// The reclaimBuckets is passed to queues which support releasing idle memory,
+            /// see LockFree::Queue, and ignored by others.
+            ChannelBase(create_only_t, const char* name, std::shared_ptr<SharedMemory> memory, bool reclaimBuckets = false)
                 : m_memory{ std::move(memory) },
-                  m_queue{ create_only, *m_memory, MakeVersionedName<DataQueue>(name), m_memory->GetAllocator<void>() },
+                  m_queue{ create_only, *m_memory, MakeVersionedName<DataQueue>(name), m_memory->GetAllocator<void>(), reclaimBuckets },
                   m_notEmptyEvent{ create_only, false, false, m_queue->m_notEmptyEventName.c_str() }
             {}
 
@@ -90,18 +93,33 @@ namespace IPC
                 return m_queue->m_count;
             }
 
+            auto& GetAwakeFlag()
+            {
+                return m_queue->m_awake;
+            }
+
         private:
             using String = ipc::basic_string<char, std::char_traits<char>, SharedMemory::Allocator<char>>;
 
             struct DataQueue : Queue
             {
-                explicit DataQueue(const SharedMemory::Allocator<char>& allocator)
-                    : ChannelBase::Queue{ allocator }, // TODO: Use "Queue" when VC14 bugs are fixed.
+                DataQueue(const SharedMemory::Allocator<char>& allocator, bool reclaimBuckets)
+                    : DataQueue{ allocator, reclaimBuckets, std::is_constructible<Queue, const SharedMemory::Allocator<char>&, bool>{} }
+                {}
+
+                DataQueue(const SharedMemory::Allocator<char>& allocator, bool reclaimBuckets, std::true_type /*reclaimable*/)
+                    : ChannelBase::Queue{ allocator, reclaimBuckets }, // TODO: Use "Queue" when VC14 bugs are fixed.
+                      m_notEmptyEventName{ GenerateRandomString().c_str(), allocator }
+                {}
+
+                DataQueue(const SharedMemory::Allocator<char>& allocator, bool /*reclaimBuckets*/, std::false_type /*reclaimable*/)
+                    : ChannelBase::Queue{ allocator },
                       m_notEmptyEventName{ GenerateRandomString().c_str(), allocator }
                 {}
 
                 const String m_notEmptyEventName;
                 std::atomic_size_t m_count{ 0 };
+                std::atomic_bool m_awake{ false };  // Set while a receiver is polling the queue, so no signal is needed.
             };
 
             std::shared_ptr<SharedMemory> m_memory;
@@ -3,6 +3,7 @@
 #include "IPC/ChannelSettings.h"
 #include "IPC/InputChannel.h"
 #include "IPC/OutputChannel.h"
+#include <cstdint>
 
 
 namespace IPC
@@ -18,13 +19,23 @@ namespace IPC
         public:
             class InstanceBase
             {
+            public:
+                /// Returns the section handle of anonymous memory for the given process, to be passed
+                /// to Open* methods there, or zero if the memory is opened by name.
+                static std::uint64_t ShareMemory(const SharedMemory& memory, std::uint32_t processId);
+
+                /// Closes the section handle returned by ShareMemory when it was never handed over.
+                static void UnshareMemory(std::uint64_t section, std::uint32_t processId) noexcept;
+
             protected:
                 std::shared_ptr<SharedMemory> GetMemory(create_only_t, bool input, const char* name, const ChannelSettingsBase& settings);
 
-                std::shared_ptr<SharedMemory> GetMemory(open_only_t, bool input, const char* name, const ChannelSettingsBase& settings);
+                std::shared_ptr<SharedMemory> GetMemory(
+                    open_only_t, bool input, const char* name, std::uint64_t section, const ChannelSettingsBase& settings);
 
             private:
-                std::shared_ptr<SharedMemory> GetMemory(bool open, bool input, const char* name, const ChannelSettingsBase& settings);
+                std::shared_ptr<SharedMemory> GetMemory(
+                    bool open, bool input, const char* name, std::uint64_t section, const ChannelSettingsBase& settings);
 
 
                 std::weak_ptr<SharedMemory> m_current;
@@ -45,39 +56,43 @@ namespace IPC
                 template <typename T>
                 auto CreateInput(const char* name)
                 {
-                    return MakeInput<T>(create_only, name);
+                    return MakeInput<T>(create_only, name, GetMemory(create_only, true, name, *this), this->IsBucketReclamationEnabled());
                 }
 
                 template <typename T>
-                auto OpenInput(const char* name)
+                auto OpenInput(const char* name, std::uint64_t section = 0)
                 {
-                    return MakeInput<T>(open_only, name);
+                    return MakeInput<T>(open_only, name, GetMemory(open_only, true, name, section, *this));
                 }
 
                 template <typename T>
                 auto CreateOutput(const char* name)
                 {
-                    return MakeOutput<T>(create_only, name);
+                    return MakeOutput<T>(create_only, name, GetMemory(create_only, false, name, *this), this->IsBucketReclamationEnabled());
                 }
 
                 template <typename T>
-                auto OpenOutput(const char* name)
+                auto OpenOutput(const char* name, std::uint64_t section = 0)
                 {
-                    return MakeOutput<T>(open_only, name);
+                    return MakeOutput<T>(open_only, name, GetMemory(open_only, false, name, section, *this));
                 }
 
             private:
-                template <typename T, typename OpenOrCreate>
-                auto MakeInput(OpenOrCreate openOrCreate, const char* name)
+                template <typename T, typename OpenOrCreate, typename... Args>
+                auto MakeInput(OpenOrCreate openOrCreate, const char* name, std::shared_ptr<SharedMemory> memory, Args&&... args)
                 {
-                    return InputChannel<T, Traits>{
-                        openOrCreate, name, GetMemory(openOrCreate, true, name, *this), this->GetWaitHandleFactory(), this->GetReceiverFactory() };
+                    InputChannel<T, Traits> channel{
+                        openOrCreate, name, std::move(memory), this->GetWaitHandleFactory(), this->GetReceiverFactory(), std::forward<Args>(args)... };
+
+                    channel.SetSpinDuration(this->GetReceiverSpinDuration());
+
+                    return channel;
                 }
 
-                template <typename T, typename OpenOrCreate>
-                auto MakeOutput(OpenOrCreate openOrCreate, const char* name)
+                template <typename T, typename OpenOrCreate, typename... Args>
+                auto MakeOutput(OpenOrCreate openOrCreate, const char* name, std::shared_ptr<SharedMemory> memory, Args&&... args)
                 {
-                    return OutputChannel<T, Traits>{ openOrCreate, name, GetMemory(openOrCreate, false, name, *this) };
+                    return OutputChannel<T, Traits>{ openOrCreate, name, std::move(memory), std::forward<Args>(args)... };
                 }
             };
 
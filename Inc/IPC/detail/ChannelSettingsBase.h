@@ -3,6 +3,7 @@
 #include <IPC/SharedMemoryCache.h>
 #include <IPC/SharedMemory.h>
 #include <memory>
+#include <chrono>
 
 
 namespace IPC
@@ -12,15 +13,15 @@ namespace IPC
         class ChannelSettingsBase
         {
         public:
-            void SetInput(std::size_t memorySize, bool allowOverride);
+            void SetInput(std::size_t memorySize, bool allowOverride, const SharedMemory::Options& options = {});
 
-            void SetOutput(std::size_t memorySize, bool allowOverride);
+            void SetOutput(std::size_t memorySize, bool allowOverride, const SharedMemory::Options& options = {});
 
             void SetInput(std::shared_ptr<SharedMemory> memory, bool allowOverride);
 
             void SetOutput(std::shared_ptr<SharedMemory> memory, bool allowOverride);
 
-            void SetInputOutput(std::size_t memorySize, bool allowOverride);
+            void SetInputOutput(std::size_t memorySize, bool allowOverride, const SharedMemory::Options& options = {});
 
             void SetInputOutput(std::shared_ptr<SharedMemory> memory, bool allowOverride);
 
@@ -34,6 +35,27 @@ namespace IPC
 
             bool IsSharedInputOutput() const;
 
+            /// Sets for how long input channel receivers keep polling after draining the queue.
+            /// See InputChannel::SetSpinDuration. Zero (default) disables polling.
+            void SetReceiverSpinDuration(std::chrono::microseconds duration);
+
+            std::chrono::microseconds GetReceiverSpinDuration() const;
+
+            /// Creates the memory of new channels without a name and passes its section handle to
+            /// the peer process, which then maps it directly instead of looking it up by name.
+            /// Common memories are not affected and must be named.
+            void SetAnonymousMemory(bool anonymous);
+
+            bool IsAnonymousMemory() const;
+
+            /// Makes the queues of new channels release the buckets left idle after a burst back
+            /// to their memory once drained. Every queue access then registers in counters shared by
+            /// both processes, so it is disabled by default. Channels opened by the peer follow the
+            /// creator's choice.
+            void SetBucketReclamation(bool reclaim);
+
+            bool IsBucketReclamationEnabled() const;
+
             const std::shared_ptr<SharedMemoryCache>& GetMemoryCache() const;
 
         protected:
@@ -46,6 +68,7 @@ namespace IPC
             struct ChannelConfig
             {
                 std::size_t m_size{ 1024 * 1024 };
+                SharedMemory::Options m_options;
                 std::shared_ptr<SharedMemory> m_common;
                 bool m_allowOverride{ true };
             };
@@ -55,6 +78,9 @@ namespace IPC
                 ChannelConfig m_input;
                 ChannelConfig m_output;
                 bool m_shared{ false };
+                bool m_anonymous{ false };
+                bool m_reclaimBuckets{ false };
+                std::chrono::microseconds m_receiverSpinDuration{ 0 };
             };
 
 
@@ -0,0 +1,280 @@
+#pragma once
+
+#include "Callback.h"
+#include "LockFree/IndexedObjectPool.h"
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <utility>
+#include <cstdint>
+
+#pragma warning(push)
+#include <boost/optional.hpp>
+#pragma warning(pop)
+
+
+namespace IPC
+{
+    namespace detail
+    {
+        /// Ready flag of a single-shot completion. Waiters spin for a while and then block
+        /// on the flag word, the completing thread wakes them up only when there are any.
+        class CompletionBase
+        {
+        public:
+            bool IsReady() const
+            {
+                return (m_flags.load(std::memory_order_acquire) & Ready) != 0;
+            }
+
+            void Wait() const;
+
+            /// Returns false when the deadline passes before the completion is ready.
+            bool WaitUntil(const std::chrono::steady_clock::time_point& deadline) const;
+
+        protected:
+            /// Marks the completion ready and wakes up the waiters.
+            /// Returns true when a continuation was set which must be run now.
+            bool SetReady();
+
+            /// Must be called after the continuation is stored.
+            /// Returns true when the completion is ready and the continuation must be run now.
+            bool SetContinuation();
+
+            void ResetFlags();
+
+        private:
+            enum Flags : std::uint32_t
+            {
+                Ready = 1,
+                Continuation = 2,
+                Waiting = 4
+            };
+
+            static constexpr std::size_t c_maxSpinCount = 4000;
+
+            bool Spin() const;
+
+
+            mutable std::atomic<std::uint32_t> m_flags{ 0 };
+        };
+
+
+        /// Pooled state shared by the consumer and the producer of a completion.
+        template <typename T>
+        class CompletionState : public CompletionBase
+        {
+        public:
+            explicit CompletionState(std::uint32_t /*index*/)
+            {}
+
+            void SetValue(T&& value)
+            {
+                m_value = std::move(value);
+                Complete();
+            }
+
+            /// Completes without a value, the consumer gets std::future_errc::broken_promise.
+            void Abandon()
+            {
+                Complete();
+            }
+
+            T GetValue()
+            {
+                Wait();
+
+                if (!m_value)
+                {
+                    throw std::future_error{ std::future_errc::broken_promise };
+                }
+
+                return std::move(*m_value);
+            }
+
+            void SetContinuation(Callback<void()> continuation)
+            {
+                m_continuation = std::move(continuation);
+
+                if (CompletionBase::SetContinuation())
+                {
+                    RunContinuation();
+                }
+            }
+
+            /// Returns true when the last of the two references is released.
+            bool Release()
+            {
+                return m_references.fetch_sub(1, std::memory_order_acq_rel) == 1;
+            }
+
+            void Reset()
+            {
+                m_value = boost::none;
+                m_continuation = {};
+                m_references.store(2, std::memory_order_relaxed);
+                ResetFlags();
+            }
+
+        private:
+            void Complete()
+            {
+                if (SetReady())
+                {
+                    RunContinuation();
+                }
+            }
+
+            void RunContinuation()
+            {
+                auto continuation = std::move(m_continuation);  // The continuation may release the state.
+                continuation();
+            }
+
+
+            boost::optional<T> m_value;
+            Callback<void()> m_continuation;
+            std::atomic<std::uint32_t> m_references{ 2 };   // The consumer and the producer.
+        };
+
+
+        template <typename T>
+        using CompletionPool = LockFree::IndexedObjectPool<CompletionState<T>, std::allocator<void>>;
+
+
+        /// Returns the process-wide pool of completion states for the type.
+        template <typename T>
+        std::shared_ptr<CompletionPool<T>> GetCompletionPool()
+        {
+            static const auto s_pool = std::make_shared<CompletionPool<T>>();
+            return s_pool;
+        }
+
+
+        /// Holds one of the two references to a pooled completion state. The pool is kept
+        /// alive by the references, so completions may outlive the static pool handle.
+        template <typename T>
+        class CompletionHolder
+        {
+        public:
+            CompletionHolder() = default;
+
+            CompletionHolder(std::shared_ptr<CompletionPool<T>> pool, CompletionState<T>& state, std::uint32_t index)
+                : m_pool{ std::move(pool) },
+                  m_state{ &state },
+                  m_index{ index }
+            {}
+
+            CompletionHolder(const CompletionHolder& other) = delete;
+            CompletionHolder& operator=(const CompletionHolder& other) = delete;
+
+            CompletionHolder(CompletionHolder&& other) noexcept
+                : m_pool{ std::move(other.m_pool) },
+                  m_state{ std::exchange(other.m_state, nullptr) },
+                  m_index{ other.m_index }
+            {}
+
+            CompletionHolder& operator=(CompletionHolder&& other) noexcept
+            {
+                if (this != &other)
+                {
+                    Reset();
+
+                    m_pool = std::move(other.m_pool);
+                    m_state = std::exchange(other.m_state, nullptr);
+                    m_index = other.m_index;
+                }
+
+                return *this;
+            }
+
+            ~CompletionHolder()
+            {
+                Reset();
+            }
+
+            explicit operator bool() const
+            {
+                return m_state != nullptr;
+            }
+
+            CompletionState<T>* operator->() const
+            {
+                return m_state;
+            }
+
+            CompletionState<T>& operator*() const
+            {
+                return *m_state;
+            }
+
+            void Reset()
+            {
+                if (auto state = std::exchange(m_state, nullptr))
+                {
+                    if (state->Release())
+                    {
+                        m_pool->Return(m_index, [](CompletionState<T>& item) { item.Reset(); });
+                    }
+
+                    m_pool = {};
+                }
+            }
+
+        private:
+            std::shared_ptr<CompletionPool<T>> m_pool;
+            CompletionState<T>* m_state{ nullptr };
+            std::uint32_t m_index{ 0 };
+        };
+
+
+        /// Producer side of a completion which is used as a response callback.
+        /// Abandons the completion when destroyed without being invoked.
+        template <typename T>
+        class CompletionSource
+        {
+        public:
+            explicit CompletionSource(CompletionHolder<T> holder)
+                : m_holder{ std::move(holder) }
+            {}
+
+            CompletionSource(CompletionSource&& other) = default;
+
+            CompletionSource& operator=(CompletionSource&& other)
+            {
+                if (this != &other)
+                {
+                    Abandon();
+                    m_holder = std::move(other.m_holder);
+                }
+
+                return *this;
+            }
+
+            ~CompletionSource()
+            {
+                Abandon();
+            }
+
+            void operator()(T value)
+            {
+                m_holder->SetValue(std::move(value));
+                m_holder.Reset();
+            }
+
+        private:
+            void Abandon()
+            {
+                if (m_holder)
+                {
+                    m_holder->Abandon();
+                    m_holder.Reset();
+                }
+            }
+
+            CompletionHolder<T> m_holder;
+        };
+
+    } // detail
+} // IPC
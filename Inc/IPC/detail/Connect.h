@@ -2,17 +2,47 @@
 
 #include "Callback.h"
 #include "IPC/Exception.h"
+#include "IPC/Policies/ReconnectPolicy.h"
 #include <string>
 #include <memory>
 #include <atomic>
 #include <mutex>
 #include <condition_variable>
+#include <exception>
+#include <type_traits>
+#include <cstddef>
 
 
 namespace IPC
 {
     namespace detail
     {
+        template <typename ErrorHandler>
+        auto HandleReconnectError(ErrorHandler& errorHandler, std::exception_ptr error, std::size_t attempt, int)
+            -> decltype(errorHandler(error, attempt), void())
+        {
+            errorHandler(std::move(error), attempt);
+        }
+
+        template <typename ErrorHandler>
+        void HandleReconnectError(ErrorHandler& errorHandler, std::exception_ptr error, std::size_t /*attempt*/, long)
+        {
+            errorHandler(std::move(error));
+        }
+
+        template <typename TimeoutFactory>
+        auto GetReconnectPolicy(const TimeoutFactory& timeoutFactory, int) -> decltype(timeoutFactory.GetReconnectPolicy())
+        {
+            return timeoutFactory.GetReconnectPolicy();
+        }
+
+        template <typename TimeoutFactory>
+        Policies::ReconnectPolicy GetReconnectPolicy(const TimeoutFactory& /*timeoutFactory*/, long)
+        {
+            return{};
+        }
+
+
         template <typename Connector, typename TimeoutFactory, typename ErrorHandler, typename ComponentFactory, typename... TransactionArgs>
         auto Connect(
             const char* acceptorName,
@@ -97,7 +127,35 @@ namespace IPC
                 }
             };
 
-            using Retry = decltype(timeoutFactory(reconnector));
+            using Scheduler = decltype(timeoutFactory(reconnector));
+            using ReconnectPolicy = std::decay_t<decltype(GetReconnectPolicy(timeoutFactory, 0))>;   // Carried by the timeout factory if it has one.
+
+            // Schedules the reconnection with a delay growing while the attempts keep failing.
+            struct Retry
+            {
+                Retry(Scheduler&& scheduler, ReconnectPolicy policy)
+                    : m_scheduler{ std::move(scheduler) },
+                      m_policy{ std::move(policy) }
+                {}
+
+                void operator()()
+                {
+                    auto delay = m_policy(m_failures);
+
+                    if (delay != decltype(delay)::zero())
+                    {
+                        m_scheduler(delay);
+                    }
+                    else
+                    {
+                        m_scheduler();
+                    }
+                }
+
+                Scheduler m_scheduler;
+                ReconnectPolicy m_policy;
+                std::atomic_size_t m_failures{ 0 };     // Consecutive failed attempts, reset once connected.
+            };
 
             callback =                                      // Set the reconnection function.
                 [lifetime,                                  // Keep track of lifetime.
@@ -105,7 +163,7 @@ namespace IPC
                     &holder,                                // Capturing reference since it lives inside the state.
                     acceptorName = std::string{ acceptorName },
                     connector,
-                    retry = std::make_shared<Retry>(timeoutFactory(reconnector)), // Make a timeout functor for the reconnection function.
+                    retry = std::make_shared<Retry>(timeoutFactory(reconnector), GetReconnectPolicy(timeoutFactory, 0)), // Make a timeout functor for the reconnection function.
                     errorHandler = std::forward<ErrorHandler>(errorHandler),
                     componentFactory = std::forward<ComponentFactory>(componentFactory)](bool async) mutable
                 {
@@ -120,10 +178,13 @@ namespace IPC
                             std::atomic_store(
                                 &holder,
                                 ComponentHolder{ componentFactory(futureConnection.get(), [retry] { (*retry)(); }) });
+
+                            retry->m_failures = 0;
                         }
                         catch (...)
                         {
-                            errorHandler(std::current_exception()); // If something goes wrong, invoke user-defined error handler
+                            // If something goes wrong, invoke user-defined error handler with the attempt number if it takes one
+                            HandleReconnectError(errorHandler, std::current_exception(), ++retry->m_failures, 0);
                             (*retry)();                             // and retry.
                         }
                     };
@@ -0,0 +1,362 @@
+#pragma once
+
+#ifdef __cpp_impl_coroutine
+
+#include "SpinLock.h"
+#include <coroutine>
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <exception>
+#include <utility>
+#include <new>
+#include <cstddef>
+
+#pragma warning(push)
+#include <boost/optional.hpp>
+#pragma warning(pop)
+
+
+namespace IPC
+{
+    namespace detail
+    {
+        /// Recycles coroutine frames. Frames are taken from the pool of the scope which is active
+        /// on the allocating thread, or from the heap when there is none, and may be freed from
+        /// any thread. Every frame keeps its pool alive.
+        class CoroutineFramePool
+        {
+        public:
+            /// Makes the pool current for the frames allocated on this thread.
+            class Scope
+            {
+            public:
+                explicit Scope(const std::shared_ptr<CoroutineFramePool>& pool)
+                    : m_previous{ s_current }
+                {
+                    s_current = &pool;
+                }
+
+                Scope(const Scope& other) = delete;
+                Scope& operator=(const Scope& other) = delete;
+
+                ~Scope()
+                {
+                    s_current = m_previous;
+                }
+
+            private:
+                const std::shared_ptr<CoroutineFramePool>* m_previous;
+            };
+
+            CoroutineFramePool() = default;
+
+            CoroutineFramePool(const CoroutineFramePool& other) = delete;
+            CoroutineFramePool& operator=(const CoroutineFramePool& other) = delete;
+
+            ~CoroutineFramePool()
+            {
+                for (auto& bucket : m_buckets)
+                {
+                    while (auto block = bucket.m_free)
+                    {
+                        bucket.m_free = block->m_next;
+                        ::operator delete(block);
+                    }
+                }
+            }
+
+            static void* Allocate(std::size_t size)
+            {
+                std::shared_ptr<CoroutineFramePool> pool;
+
+                if (s_current)
+                {
+                    pool = *s_current;
+                }
+
+                size += c_headerSize;
+
+                auto block = pool ? pool->Take(size) : ::operator new(size);
+                new (block) Header{ std::move(pool) };
+
+                return static_cast<char*>(block) + c_headerSize;
+            }
+
+            static void Deallocate(void* frame, std::size_t size)
+            {
+                auto block = static_cast<char*>(frame) - c_headerSize;
+                auto& header = *reinterpret_cast<Header*>(block);
+                auto pool = std::move(header.m_pool);
+
+                header.~Header();
+
+                if (pool)
+                {
+                    pool->Put(block, size + c_headerSize);
+                }
+                else
+                {
+                    ::operator delete(block);
+                }
+            }
+
+        private:
+            struct Header
+            {
+                std::shared_ptr<CoroutineFramePool> m_pool;
+            };
+
+            struct FreeBlock
+            {
+                FreeBlock* m_next;
+            };
+
+            struct Bucket
+            {
+                std::size_t m_size;
+                FreeBlock* m_free;
+            };
+
+            static constexpr std::size_t c_headerSize =
+                (sizeof(Header) + __STDCPP_DEFAULT_NEW_ALIGNMENT__ - 1) / __STDCPP_DEFAULT_NEW_ALIGNMENT__ * __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+            void* Take(std::size_t size)
+            {
+                {
+                    std::lock_guard<SpinLock> guard{ m_lock };
+
+                    for (auto& bucket : m_buckets)
+                    {
+                        if (bucket.m_size == size)
+                        {
+                            if (auto block = bucket.m_free)
+                            {
+                                bucket.m_free = block->m_next;
+                                return block;
+                            }
+
+                            break;
+                        }
+                    }
+                }
+
+                return ::operator new(size);
+            }
+
+            void Put(void* block, std::size_t size)
+            {
+                auto freeBlock = new (block) FreeBlock{ nullptr };
+
+                std::lock_guard<SpinLock> guard{ m_lock };
+
+                for (auto& bucket : m_buckets)
+                {
+                    if (bucket.m_size == size)
+                    {
+                        freeBlock->m_next = bucket.m_free;
+                        bucket.m_free = freeBlock;
+                        return;
+                    }
+                }
+
+                m_buckets.push_back({ size, freeBlock });   // Frames of a connection come in a few sizes.
+            }
+
+
+            static inline thread_local const std::shared_ptr<CoroutineFramePool>* s_current{ nullptr };
+
+            SpinLock m_lock;
+            std::vector<Bucket> m_buckets;
+        };
+
+
+        /// Allocates coroutine frames from the current CoroutineFramePool.
+        struct CoroutinePromiseBase
+        {
+            static void* operator new(std::size_t size)
+            {
+                return CoroutineFramePool::Allocate(size);
+            }
+
+            static void operator delete(void* frame, std::size_t size)
+            {
+                CoroutineFramePool::Deallocate(frame, size);
+            }
+        };
+
+
+        /// Promise of a lazily started task which resumes its awaiter when done.
+        class TaskPromiseBase : public CoroutinePromiseBase
+        {
+            struct FinalAwaiter
+            {
+                bool await_ready() const noexcept
+                {
+                    return false;
+                }
+
+                template <typename Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept
+                {
+                    return handle.promise().m_continuation;
+                }
+
+                void await_resume() const noexcept
+                {}
+            };
+
+        public:
+            std::suspend_always initial_suspend() const noexcept
+            {
+                return{};
+            }
+
+            FinalAwaiter final_suspend() const noexcept
+            {
+                return{};
+            }
+
+            void unhandled_exception()
+            {
+                m_exception = std::current_exception();
+            }
+
+            void SetContinuation(std::coroutine_handle<> continuation)
+            {
+                m_continuation = continuation;
+            }
+
+        protected:
+            void RethrowIfFailed() const
+            {
+                if (m_exception)
+                {
+                    std::rethrow_exception(m_exception);
+                }
+            }
+
+        private:
+            std::coroutine_handle<> m_continuation{ std::noop_coroutine() };
+            std::exception_ptr m_exception;
+        };
+
+
+        template <typename T>
+        class TaskPromise : public TaskPromiseBase
+        {
+        public:
+            template <typename U>
+            void return_value(U&& value)
+            {
+                m_value.emplace(std::forward<U>(value));
+            }
+
+            T GetValue()
+            {
+                RethrowIfFailed();
+                return std::move(*m_value);
+            }
+
+        private:
+            boost::optional<T> m_value;
+        };
+
+
+        template <>
+        class TaskPromise<void> : public TaskPromiseBase
+        {
+        public:
+            void return_void() const noexcept
+            {}
+
+            void GetValue() const
+            {
+                RethrowIfFailed();
+            }
+        };
+
+
+        /// Coroutine which starts immediately and frees itself when done. Exceptions are dropped.
+        struct DetachedTask
+        {
+            struct promise_type : CoroutinePromiseBase
+            {
+                DetachedTask get_return_object() const noexcept
+                {
+                    return{};
+                }
+
+                std::suspend_never initial_suspend() const noexcept
+                {
+                    return{};
+                }
+
+                std::suspend_never final_suspend() const noexcept
+                {
+                    return{};
+                }
+
+                void return_void() const noexcept
+                {}
+
+                void unhandled_exception() const noexcept
+                {}
+            };
+        };
+
+
+        /// Suspends the coroutine until the callback passed to the start function receives a
+        /// future-like result and resumes it through the executor. The coroutine is not suspended
+        /// when the callback is invoked before the start function returns.
+        template <typename Result, typename Start, typename Executor>
+        class FutureAwaiter
+        {
+        public:
+            FutureAwaiter(Start start, Executor executor)
+                : m_start{ std::move(start) },
+                  m_executor{ std::move(executor) }
+            {}
+
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            bool await_suspend(std::coroutine_handle<> handle)
+            {
+                m_handle = handle;
+
+                m_start(
+                    [this](Result&& result)
+                    {
+                        m_result.emplace(std::move(result));
+
+                        if (m_completed.exchange(true, std::memory_order_acq_rel))
+                        {
+                            auto executor = std::move(m_executor);  // The resumed coroutine may destroy this.
+                            executor([handle = m_handle] { handle.resume(); });
+                        }
+                    });
+
+                return !m_completed.exchange(true, std::memory_order_acq_rel);
+            }
+
+            decltype(auto) await_resume()
+            {
+                return m_result->get();
+            }
+
+        private:
+            Start m_start;
+            Executor m_executor;
+            std::coroutine_handle<> m_handle;
+            boost::optional<Result> m_result;
+            std::atomic_bool m_completed{ false };
+        };
+
+    } // detail
+} // IPC
+
+#endif // __cpp_impl_coroutine
@@ -5,9 +5,13 @@
 
 #pragma warning(push)
 #include <boost/interprocess/containers/string.hpp>
+#include <boost/interprocess/offset_ptr.hpp>
 #include <boost/optional.hpp>
 #pragma warning(pop)
 
+#include <atomic>
+#include <cstdint>
+
 
 namespace IPC
 {
@@ -21,6 +25,48 @@ namespace IPC
             boost::optional<String> m_commonOutputMemoryName;
         };
 
+        /// Connection pre-created by the acceptor which a connector claims without a round trip.
+        struct AcceptorSlot
+        {
+            enum class State : std::uint32_t
+            {
+                Free,       // Being filled by the acceptor.
+                Ready,
+                Claimed,
+                Failed      // The connector could not open the channels, refilled by the acceptor.
+            };
+
+            explicit AcceptorSlot(const String::allocator_type& allocator);
+
+            /// The state is packed with the id of the claiming process, so that the acceptor can
+            /// recycle a slot whose connector died right after claiming it.
+            static constexpr std::uint64_t MakeState(State state, std::uint32_t processId = 0)
+            {
+                return (static_cast<std::uint64_t>(processId) << 32) | static_cast<std::uint32_t>(state);
+            }
+
+            static constexpr State GetState(std::uint64_t value)
+            {
+                return static_cast<State>(static_cast<std::uint32_t>(value));
+            }
+
+            static constexpr std::uint32_t GetProcessId(std::uint64_t value)
+            {
+                return static_cast<std::uint32_t>(value >> 32);
+            }
+
+            std::atomic_uint64_t m_state{ MakeState(State::Free) };
+            String m_closeEventName;
+            String m_acceptorChannelName;   // Input of the acceptor.
+            String m_connectorChannelName;  // Input of the connector.
+        };
+
+        /// Sent by the connector after it has opened the channels of a claimed slot.
+        struct AcceptorSlotClaim
+        {
+            std::uint32_t m_index;
+        };
+
         struct AcceptorHostInfo
         {
             explicit AcceptorHostInfo(const String::allocator_type& allocator);
@@ -28,6 +74,9 @@ namespace IPC
             std::uint32_t m_processId{};
             String m_acceptorCloseEventName;
 
+            ipc::offset_ptr<AcceptorSlot> m_slots;
+            std::uint32_t m_slotCount{};
+
             Settings m_settings;
 
             // TODO: Add compatibility version info.
@@ -41,6 +90,8 @@ namespace IPC
             String m_connectorCloseEventName;
             String m_connectorInfoChannelName;
             String m_acceptorInfoChannelName;
+            std::uint64_t m_connectorInfoChannelMemory{};   // Section handle of anonymous memory, see SharedMemory::Share.
+            std::uint64_t m_acceptorInfoChannelMemory{};
 
             Settings m_settings;
         };
@@ -50,6 +101,7 @@ namespace IPC
             explicit ConnectorInfo(const String::allocator_type& allocator);
 
             String m_channelName;
+            std::uint64_t m_channelMemory{};
         };
 
         struct AcceptorInfo
@@ -58,6 +110,7 @@ namespace IPC
 
             String m_closeEventName;
             String m_channelName;
+            std::uint64_t m_channelMemory{};
         };
 
     } // detail
@@ -12,7 +12,12 @@ namespace IPC
         public:
             explicit KernelProcess(std::uint32_t pid);
 
+            std::uint32_t GetId() const;
+
             static std::uint32_t GetCurrentProcessId();
+
+        private:
+            std::uint32_t m_id;
         };
         
     } // detail
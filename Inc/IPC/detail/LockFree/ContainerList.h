@@ -4,6 +4,10 @@
 #include <memory>
 #include <atomic>
 #include <mutex>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+#include <cassert>
 
 
 namespace IPC
@@ -15,7 +19,10 @@ namespace IPC
         /// Provides a lock-free access to a list of containers with dynamically growing
         /// capacity. Capacity growth is synchronized. Can be allocated directly in
         /// shared memory as along as container type has same capability.
-        template <typename Container, typename AllocatorT>
+        /// When Reclaimable is set, trailing nodes can be released with Trim once enabled with
+        /// EnableReclamation. Readers are then tracked with epoch counters stored in the list
+        /// itself, so reclamation is safe across processes.
+        template <typename Container, typename AllocatorT, bool Reclaimable = false>
         class ContainerList
         {
         public:
@@ -31,6 +38,7 @@ namespace IPC
             template <typename Function>
             bool TryApply(Function&& func) const
             {
+                typename Reclaimer::Guard guard{ m_reclaimer };
                 return m_head.TryApply(std::forward<Function>(func)) == nullptr;
             }
 
@@ -39,6 +47,7 @@ namespace IPC
             template <typename Function>
             bool TryApply(Function&& func)
             {
+                typename Reclaimer::Guard guard{ m_reclaimer };
                 return m_head.TryApply(std::forward<Function>(func)) == nullptr;
             }
 
@@ -48,10 +57,178 @@ namespace IPC
             template <typename Function, typename... Args>
             void Apply(Function&& func, Args&&... args)
             {
+                typename Reclaimer::Guard guard{ m_reclaimer };
                 m_head.Apply(std::forward<Function>(func), m_allocator, m_lock, std::forward<Args>(args)...);
             }
 
+            /// Starts tracking readers so that Trim can be used. Must be called before the list
+            /// is shared with other threads or processes.
+            void EnableReclamation()
+            {
+                static_assert(Reclaimable, "Trim is only supported for reclaimable lists.");
+
+                m_reclaimer.Enable();
+            }
+
+            bool IsReclaimable() const
+            {
+                return m_reclaimer.IsEnabled();
+            }
+
+            /// Returns true while a trim keeps nodes detached, which only a later Trim call finishes.
+            bool IsTrimPending() const
+            {
+                return m_reclaimer.GetPendingPosition() != 0;
+            }
+
+            /// Releases the trailing container nodes for which the provided function returns true,
+            /// always keeping at least the given number of leading nodes. This is a best-effort
+            /// operation which never waits. The nodes are detached first and released by a later
+            /// call once readers which could have seen them are gone, so callers must keep calling
+            /// it while IsTrimPending. It gives up when another trim is running, and attaches the
+            /// nodes back when a writer needs them to grow or has already filled them.
+            /// Returns true if no trailing nodes are left to release.
+            template <typename Function>
+            bool Trim(Function&& func, std::size_t keepCount = 1)
+            {
+                static_assert(Reclaimable, "Trim is only supported for reclaimable lists.");
+                assert(IsReclaimable());
+
+                std::unique_lock<SpinLock> guard{ m_reclaimer.GetLock(), std::try_to_lock };
+
+                return guard && m_head.Trim(func, (std::max)(keepCount, std::size_t{ 1 }), m_lock, m_reclaimer);
+            }
+
         private:
+            struct NullReclaimer
+            {
+                struct Guard
+                {
+                    explicit Guard(const NullReclaimer& /*reclaimer*/)
+                    {}
+                };
+
+                bool IsEnabled() const
+                {
+                    return false;
+                }
+
+                std::size_t GetPendingPosition() const
+                {
+                    return 0;
+                }
+            };
+
+            /// Tracks readers with two epoch counters once enabled. A grace period flips the epoch
+            /// twice and each time lets the counter of the previous epoch drop to zero. It is advanced
+            /// without blocking by repeated calls. Only the holder of the lock may use it.
+            class EpochReclaimer
+            {
+            public:
+                class Guard
+                {
+                public:
+                    explicit Guard(const EpochReclaimer& reclaimer)
+                        : m_readers{ reclaimer.m_enabled ? &reclaimer.Enter() : nullptr }
+                    {}
+
+                    Guard(const Guard& other) = delete;
+                    Guard& operator=(const Guard& other) = delete;
+
+                    ~Guard()
+                    {
+                        if (m_readers)
+                        {
+                            m_readers->fetch_sub(1, std::memory_order_release);
+                        }
+                    }
+
+                private:
+                    std::atomic_uint32_t* m_readers;
+                };
+
+                void Enable()
+                {
+                    m_enabled = true;
+                }
+
+                bool IsEnabled() const
+                {
+                    return m_enabled;
+                }
+
+                SpinLock& GetLock()
+                {
+                    return m_lock;
+                }
+
+                /// Returns the position of the last node kept by a pending trim, or zero if there is none.
+                std::size_t GetPendingPosition() const
+                {
+                    return m_pendingPosition.load(std::memory_order_relaxed);
+                }
+
+                /// Starts a grace period for nodes detached after the node at the given position.
+                void SetPending(std::size_t position)
+                {
+                    m_pendingPosition.store(position, std::memory_order_relaxed);
+                    m_flipCount = 0;
+                }
+
+                void ResetPending()
+                {
+                    SetPending(0);
+                }
+
+                /// Advances the grace period. Returns true once it has passed.
+                bool TryWaitForReaders()
+                {
+                    for (;;)
+                    {
+                        if (m_flipCount != 0 && m_readers[(m_epoch.load() - 1) & 1].load() != 0)
+                        {
+                            return false;   // Readers of the epoch before the last flip are still inside.
+                        }
+
+                        if (m_flipCount == 2)
+                        {
+                            return true;
+                        }
+
+                        m_epoch.fetch_add(1);
+                        ++m_flipCount;
+                    }
+                }
+
+            private:
+                std::atomic_uint32_t& Enter() const
+                {
+                    for (;;)
+                    {
+                        auto epoch = m_epoch.load();
+                        auto& readers = m_readers[epoch & 1];
+
+                        readers.fetch_add(1);
+
+                        if (m_epoch.load() == epoch)
+                        {
+                            return readers;
+                        }
+
+                        readers.fetch_sub(1, std::memory_order_release);
+                    }
+                }
+
+                std::atomic_uint32_t m_epoch{ 0 };
+                mutable std::atomic_uint32_t m_readers[2] = {};
+                SpinLock m_lock;
+                std::atomic_size_t m_pendingPosition{ 0 };  // One-based, only changed under m_lock.
+                std::uint32_t m_flipCount{ 0 };
+                bool m_enabled{ false };                    // Set before the list is shared.
+            };
+
+            using Reclaimer = std::conditional_t<Reclaimable, EpochReclaimer, NullReclaimer>;
+
             class Node
             {
             public:
@@ -96,6 +273,90 @@ namespace IPC
                     }
                 }
 
+                template <typename Function, typename ReclaimerT>
+                bool Trim(Function& func, std::size_t keepCount, SpinLock& lock, ReclaimerT& reclaimer)
+                {
+                    Node* last{ nullptr };  // Last node to keep.
+                    {
+                        std::lock_guard<SpinLock> guard{ lock };
+
+                        if (auto position = reclaimer.GetPendingPosition())
+                        {
+                            last = this;
+
+                            while (--position != 0)
+                            {
+                                last = std::addressof(*last->m_next);
+                            }
+
+                            if (!last->m_tail.load(std::memory_order_relaxed))
+                            {
+                                last = nullptr;     // A writer attached the nodes back.
+                                reclaimer.ResetPending();
+                            }
+                        }
+
+                        if (!last)
+                        {
+                            last = this;
+                            std::size_t index{ 0 }, lastIndex{ 0 };
+
+                            for (auto node = this; !node->m_tail.load(std::memory_order_relaxed); )
+                            {
+                                node = std::addressof(*node->m_next);
+
+                                if (++index < keepCount || !func(node->m_container))
+                                {
+                                    last = node;
+                                    lastIndex = index;
+                                }
+                            }
+
+                            if (last->m_tail.load(std::memory_order_relaxed))
+                            {
+                                return true;
+                            }
+
+                            last->m_tail.store(true);   // Detach the rest of the list from new readers.
+                            reclaimer.SetPending(lastIndex + 1);
+                        }
+                    }
+
+                    // The lock is not held here, so writers which need to grow can attach the nodes back.
+                    if (!reclaimer.TryWaitForReaders())
+                    {
+                        std::lock_guard<SpinLock> guard{ lock };
+
+                        // A writer which went past the last node before it was detached may have pushed
+                        // into the detached ones, which readers cannot see until they are attached back.
+                        if (last->m_tail.load(std::memory_order_relaxed) && !last->m_next->AllOf(func))
+                        {
+                            last->m_tail.store(false, std::memory_order_release);
+                            reclaimer.ResetPending();
+                        }
+
+                        return false;   // Otherwise leave the nodes detached for the next trim.
+                    }
+
+                    reclaimer.ResetPending();
+
+                    std::lock_guard<SpinLock> guard{ lock };
+
+                    if (!last->m_tail.load(std::memory_order_relaxed))
+                    {
+                        return false;
+                    }
+
+                    if (last->m_next->AllOf(func))
+                    {
+                        last->m_next.reset();
+                        return true;
+                    }
+
+                    last->m_tail.store(false, std::memory_order_release);   // Still in use, attach it back.
+                    return false;
+                }
+
             private:
                 class Deleter
                 {
@@ -136,19 +397,39 @@ namespace IPC
                             return nullptr;
                         }
 
-                        if (node->m_tail.load(std::memory_order_relaxed))
+                        if (node->m_tail.load(std::memory_order_acquire))
                         {
                             return node;
                         }
                     }
                 }
 
+                template <typename Function>
+                bool AllOf(Function& func)
+                {
+                    for (auto node = this; func(node->m_container); node = std::addressof(*node->m_next))
+                    {
+                        if (node->m_tail.load(std::memory_order_relaxed))
+                        {
+                            return true;
+                        }
+                    }
+
+                    return false;
+                }
+
                 template <typename Function>
                 __declspec(noinline) bool UpdateTail(Function&& func, SpinLock& lock, std::unique_ptr<Node, Deleter>&& newNode)
                 {
                     assert(newNode);
                     std::lock_guard<SpinLock> guard{ lock };
 
+                    if (m_tail.load(std::memory_order_acquire) && m_next)
+                    {
+                        m_tail.store(false, std::memory_order_release); // Attach back the nodes detached by a pending trim.
+                        return false;
+                    }
+
                     if (m_tail.load(std::memory_order_acquire) && func(newNode->m_container))
                     {
                         m_next = std::move(newNode);
@@ -187,6 +468,7 @@ namespace IPC
             typename Node::Allocator m_allocator;   // Allocator must be the first one.
             Node m_head;
             SpinLock m_lock;
+            mutable Reclaimer m_reclaimer;
         };
 
     } // LockFree
@@ -6,6 +6,9 @@
 #pragma warning(pop)
 
 #include <array>
+#include <atomic>
+#include <iterator>
+#include <type_traits>
 
 
 namespace IPC
@@ -22,133 +25,274 @@ namespace IPC
 
 
         /// Specialization for complex (non-trivially copyable) types.
+        /// Implemented as a bounded ring of slots where each slot carries a turn counter
+        /// next to the inline storage, so pushing or popping costs a single position update.
         template <typename T, std::size_t Capacity, typename Enable>
         class FixedQueue
         {
         public:
-            FixedQueue()
-            {
-                for (std::size_t i = 0; i < Capacity; ++i)
-                {
-                    m_pool.push(i);
-                }
-            }
+            FixedQueue() = default;
 
             FixedQueue(const FixedQueue& other) = delete;
             FixedQueue& operator=(const FixedQueue& other) = delete;
 
             ~FixedQueue()
             {
-                m_queue.consume_all(
-                    [this](std::size_t index)
-                    {
-                        auto obj = reinterpret_cast<T*>(&m_storage[index]);
-                        obj->~T();
-                        (void)obj;
-                    });
+                ConsumeAll([](T&&) {});
             }
 
             bool IsEmpty() const
             {
-                return m_queue.empty();
+                for (auto pos = m_tail.m_value.load(std::memory_order_acquire), end = pos + Capacity; pos != end; ++pos)
+                {
+                    auto turn = m_slots[pos % Capacity].m_turn.load(std::memory_order_acquire);
+
+                    if (turn != Turn(pos, State::Hole))
+                    {
+                        return turn != Turn(pos, State::Full);
+                    }
+                }
+
+                return true;
             }
 
             template <typename U>
             bool Push(U&& value)
             {
-                std::size_t index;
-                if (m_pool.pop(index))
+                auto pos = m_head.m_value.load(std::memory_order_acquire);
+
+                for (;;)
                 {
-                    try
+                    auto& slot = m_slots[pos % Capacity];
+
+                    if (slot.m_turn.load(std::memory_order_acquire) == Turn(pos, State::Empty))
                     {
-                        new (&m_storage[index]) T(std::forward<U>(value));
+                        if (m_head.m_value.compare_exchange_strong(pos, pos + 1))
+                        {
+                            try
+                            {
+                                new (&slot.m_storage) T(std::forward<U>(value));
+                            }
+                            catch (...)
+                            {
+                                slot.m_turn.store(Turn(pos, State::Hole), std::memory_order_release);   // The slot is already claimed, so leave a hole for readers to skip.
+                                throw;
+                            }
+
+                            slot.m_turn.store(Turn(pos, State::Full), std::memory_order_release);
+                            return true;
+                        }
                     }
-                    catch (...)
+                    else
                     {
-                        auto result = m_pool.push(index);
-                        assert(result);
-                        (void)result;
-                        throw;
-                    }
-
-                    auto result = m_queue.push(index);
-                    assert(result);
+                        auto prev = pos;
+                        pos = m_head.m_value.load(std::memory_order_acquire);
 
-                    return result;
+                        if (pos == prev && !SkipHole())
+                        {
+                            return false;
+                        }
+                    }
                 }
-
-                return false;
             }
 
-            boost::optional<T> Pop()
+            /// Pushes a prefix of the range claiming all the free slots it needs at once.
+            /// Returns the number of elements pushed. Elements past that are not moved out.
+            /// The elements are published after all of them are constructed, so when a
+            /// constructor throws nothing is pushed and the claimed slots are left as holes.
+            template <typename Iterator>
+            std::size_t Push(Iterator first, Iterator last)
             {
-                boost::optional<T> value;
+                auto size = static_cast<std::size_t>(std::distance(first, last));
+                auto pos = m_head.m_value.load(std::memory_order_acquire);
+                std::size_t count;
 
-                std::size_t index;
-                if (m_queue.pop(index))
+                for (;;)
                 {
-                    auto obj = reinterpret_cast<T*>(&m_storage[index]);
+                    for (count = 0; count != size && count != Capacity
+                        && m_slots[(pos + count) % Capacity].m_turn.load(std::memory_order_acquire) == Turn(pos + count, State::Empty); ++count)
+                    {}
 
-                    auto restoreIndex = [&]
+                    if (count != 0)
                     {
-                        auto result = m_pool.push(index);
-                        assert(result);
-                        (void)result;
-                    };
+                        if (m_head.m_value.compare_exchange_strong(pos, pos + count))
+                        {
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        auto prev = pos;
+                        pos = m_head.m_value.load(std::memory_order_acquire);
+
+                        if (size == 0 || (pos == prev && !SkipHole()))
+                        {
+                            return 0;
+                        }
+                    }
+                }
 
-                    try
+                std::size_t i = 0;
+
+                try
+                {
+                    for (; i != count; ++i, ++first)
                     {
-                        value = std::move(*obj);
-                        obj->~T();
+                        new (&m_slots[(pos + i) % Capacity].m_storage) T(*first);
                     }
-                    catch (...)
+                }
+                catch (...)
+                {
+                    for (std::size_t j = 0; j != count; ++j)
                     {
-                        restoreIndex();
-                        throw;
+                        auto& slot = m_slots[(pos + j) % Capacity];
+
+                        if (j < i)
+                        {
+                            reinterpret_cast<T*>(&slot.m_storage)->~T();
+                        }
+
+                        slot.m_turn.store(Turn(pos + j, State::Hole), std::memory_order_release);
                     }
 
-                    restoreIndex();
+                    throw;
+                }
+
+                for (i = 0; i != count; ++i)
+                {
+                    m_slots[(pos + i) % Capacity].m_turn.store(Turn(pos + i, State::Full), std::memory_order_release);
                 }
 
+                return count;
+            }
+
+            boost::optional<T> Pop()
+            {
+                boost::optional<T> value;
+
+                TryConsume([&](T&& obj) { value = std::move(obj); });
+
                 return value;
             }
 
             template <typename Function>
             std::size_t ConsumeAll(Function&& func)
             {
-                return m_queue.consume_all(
-                    [this, &func](std::size_t index)
-                    {
-                        auto obj = reinterpret_cast<T*>(&m_storage[index]);
+                std::size_t count{ 0 };
 
-                        auto restoreIndex = [&]
-                        {
-                            auto result = m_pool.push(index);
-                            assert(result);
-                            (void)result;
-                        };
+                while (TryConsume(func))
+                {
+                    ++count;
+                }
+
+                return count;
+            }
+
+        private:
+            static constexpr std::size_t c_cacheLineSize = 64;
+
+            enum class State : std::size_t
+            {
+                Empty,
+                Full,
+                Hole
+            };
+
+            // Padding is used instead of alignas since shared memory allocations do not honor extended alignment.
+            struct Position
+            {
+                std::atomic_size_t m_value{ 0 };
+                char m_padding[c_cacheLineSize - sizeof(std::atomic_size_t)];
+            };
+
+            struct Slot
+            {
+                std::atomic_size_t m_turn{ 0 };
+                std::aligned_storage_t<sizeof(T), alignof(T)> m_storage;
+            };
+
+            /// Each lap around the ring moves a slot through Empty -> Full (or Hole) -> Empty of the next lap.
+            static constexpr std::size_t Turn(std::size_t pos, State state)
+            {
+                return (pos / Capacity) * 3 + static_cast<std::size_t>(state);
+            }
+
+            bool SkipHole()
+            {
+                auto pos = m_tail.m_value.load(std::memory_order_acquire);
+                auto& slot = m_slots[pos % Capacity];
+
+                if (slot.m_turn.load(std::memory_order_acquire) == Turn(pos, State::Hole)
+                    && m_tail.m_value.compare_exchange_strong(pos, pos + 1))
+                {
+                    slot.m_turn.store(Turn(pos + Capacity, State::Empty), std::memory_order_release);
+                    return true;
+                }
 
-                        try
+                return false;
+            }
+
+            template <typename Function>
+            bool TryConsume(Function&& func)
+            {
+                auto pos = m_tail.m_value.load(std::memory_order_acquire);
+
+                for (;;)
+                {
+                    auto& slot = m_slots[pos % Capacity];
+                    auto turn = slot.m_turn.load(std::memory_order_acquire);
+
+                    if (turn == Turn(pos, State::Full) || turn == Turn(pos, State::Hole))
+                    {
+                        if (m_tail.m_value.compare_exchange_strong(pos, pos + 1))
                         {
-                            func(std::move(*obj));
+                            auto release = [&]
+                            {
+                                slot.m_turn.store(Turn(pos + Capacity, State::Empty), std::memory_order_release);
+                            };
+
+                            if (turn == Turn(pos, State::Hole))
+                            {
+                                release();
+                                pos = m_tail.m_value.load(std::memory_order_acquire);
+                                continue;
+                            }
+
+                            auto obj = reinterpret_cast<T*>(&slot.m_storage);
+
+                            try
+                            {
+                                func(std::move(*obj));
+                            }
+                            catch (...)
+                            {
+                                obj->~T();
+                                release();
+                                throw;
+                            }
+
                             obj->~T();
+                            release();
+                            return true;
                         }
-                        catch (...)
+                    }
+                    else
+                    {
+                        auto prev = pos;
+                        pos = m_tail.m_value.load(std::memory_order_acquire);
+
+                        if (pos == prev)
                         {
-                            restoreIndex();
-                            throw;
+                            return false;
                         }
-
-                        restoreIndex();
-                    });
+                    }
+                }
             }
 
-        private:
-            using Queue = boost::lockfree::queue<std::size_t, boost::lockfree::capacity<Capacity>>;
 
-            Queue m_pool;
-            Queue m_queue;
-            std::array<std::aligned_storage_t<sizeof(T), alignof(T)>, Capacity> m_storage;
+            Position m_head;    // Next position to write.
+            Position m_tail;    // Next position to read.
+            std::array<Slot, Capacity> m_slots;
         };
 
 
@@ -167,6 +311,19 @@ namespace IPC
                 return m_queue.push(value);
             }
 
+            template <typename Iterator>
+            std::size_t Push(Iterator first, Iterator last)
+            {
+                std::size_t count{ 0 };
+
+                for (; first != last && m_queue.push(*first); ++first)
+                {
+                    ++count;
+                }
+
+                return count;
+            }
+
             boost::optional<T> Pop()
             {
                 T value;
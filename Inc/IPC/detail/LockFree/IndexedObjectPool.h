@@ -1,10 +1,13 @@
 #pragma once
 
-#include "Queue.h"
 #include "ContainerList.h"
+#include "IPC/Exception.h"
 #include <memory>
 #include <array>
 #include <atomic>
+#include <limits>
+#include <cassert>
+#include <intrin.h>
 
 #pragma warning(push)
 #include <boost/optional.hpp>
@@ -19,37 +22,40 @@ namespace IPC
     {
         /// Provides an object pool of any type with dynamically growing capacity
         /// where each object is referred by index. Object retrieval and return are
-        /// lock-free. Capacity growth is synchronized. Can be allocated directly in
-        /// shared memory as along as T has same capability.
-        template <typename T, typename Allocator, std::uint32_t BucketSize = 64>
+        /// lock-free. Capacity growth is synchronized. Objects are looked up by index
+        /// in constant time. Can be allocated directly in shared memory as along as
+        /// T has same capability. When GenerationBits is not zero, the upper bits of
+        /// an index carry a generation which changes every time the object is taken,
+        /// so indices of returned objects are rejected after the object is reused.
+        template <typename T, typename Allocator, std::uint32_t BucketSize = 64, std::uint32_t GenerationBits = 0>
         class IndexedObjectPool
         {
         public:
             using Index = std::uint32_t;
 
+            static_assert(GenerationBits < 32, "Generation must leave room for the object index.");
+
             IndexedObjectPool()
                 : IndexedObjectPool{ {} }
             {}
 
             explicit IndexedObjectPool(const Allocator& allocator)
                 : m_buckets{ allocator },
-                  m_pool{ allocator }
-            {}
+                  m_directory{ allocator }
+            {
+                m_buckets.TryApply([this](auto& bucket) { m_directory.Add(bucket); return true; });
+            }
 
             /// Retrieves or constructs a new object with index as first argument
-            /// followed by provided arguments.
+            /// followed by provided arguments. The object is always constructed
+            /// with the first generation of the index.
             /// \returns A pair of object reference and index.
             template <typename... Args>
             std::pair<T&, Index> Take(Args&&... args)
             {
-                if (auto index = m_pool.Pop())
+                if (auto item = PopFree())
                 {
-                    auto item = Get(*index);
-                    assert(item);
-
-                    item->MarkUsed();
-
-                    return{ **item, *index };
+                    return{ *item->first, MakeIndex(item->second, item->first.MarkUsed()) };
                 }
 
                 return Construct(std::forward<Args>(args)...);
@@ -63,12 +69,15 @@ namespace IPC
 
             /// Returns the object with given index back to the pool and
             /// invokes the function before it becomes available for retrieval.
+            /// Fails when the generation of the index is not current.
             template <typename Function>
             bool Return(Index index, Function&& func)
             {
-                if (auto item = Get(index))
+                auto slot = index & c_slotMask;
+
+                if (auto item = Get(slot))
                 {
-                    if (item->MarkFree())
+                    if (item->MarkFree(GetGeneration(index)))
                     {
                         try
                         {
@@ -76,11 +85,11 @@ namespace IPC
                         }
                         catch (...)
                         {
-                            m_pool.Push(index);
+                            PushFree(*item, slot);
                             throw;
                         }
 
-                        m_pool.Push(index);
+                        PushFree(*item, slot);
                         return true;
                     }
                 }
@@ -111,24 +120,55 @@ namespace IPC
             }
 
         private:
+            static constexpr Index c_slotBits = 32 - GenerationBits;
+            static constexpr Index c_slotMask = static_cast<Index>((std::uint64_t{ 1 } << c_slotBits) - 1);
+            static constexpr Index c_generationMask = static_cast<Index>((std::uint64_t{ 1 } << GenerationBits) - 1);
+
+            static constexpr Index MakeIndex(Index slot, Index generation)
+            {
+                return static_cast<Index>(slot | (std::uint64_t{ generation } << c_slotBits));
+            }
+
+            static constexpr Index GetGeneration(Index index)
+            {
+                return static_cast<Index>(std::uint64_t{ index } >> c_slotBits);
+            }
+
             class Bucket
             {
             public:
                 class Item : public boost::optional<T>
                 {
                 public:
-                    void MarkUsed()
+                    /// Starts the next generation, only invoked by the thread which popped the free item.
+                    Index MarkUsed()
                     {
-                        m_free.clear();
+                        auto generation = ((m_state.load(std::memory_order_relaxed) >> 1) + 1) & c_generationMask;
+                        m_state.store(generation << 1, std::memory_order_relaxed);
+                        return generation;
                     }
 
+                    /// Frees the item in any generation.
                     bool MarkFree()
                     {
-                        return !m_free.test_and_set();
+                        return (m_state.fetch_or(1) & 1) == 0;
+                    }
+
+                    /// Frees the item only when it is used in the given generation.
+                    bool MarkFree(Index generation)
+                    {
+                        auto used = generation << 1;
+                        return m_state.compare_exchange_strong(used, used | 1);
+                    }
+
+                    std::atomic<Index>& GetNextFree()
+                    {
+                        return m_nextFree;
                     }
 
                 private:
-                    std::atomic_flag m_free{ ATOMIC_FLAG_INIT };
+                    std::atomic<Index> m_state{ 0 };    // The generation shifted left by one with the lowest bit set when free.
+                    std::atomic<Index> m_nextFree{ 0 };
                 };
 
 
@@ -141,6 +181,11 @@ namespace IPC
                         auto& item = m_items[index];
                         index += offset;
 
+                        if (index > c_slotMask)
+                        {
+                            throw Exception{ "Object pool index space is exhausted." };   // Wastes the slot same as a throwing .ctor.
+                        }
+
                         item.emplace(index, std::forward<Args>(args)...);   // Intentionally waste the slot if .ctor throws.
 
                         return{ &*item, index };
@@ -177,23 +222,123 @@ namespace IPC
             };
 
 
+            /// Maps bucket indices to buckets. Entries are stored in chunks of geometrically
+            /// growing size which are never moved, so lookups need no synchronization other
+            /// than reading the published size. Additions must be serialized.
+            class Directory
+            {
+                using BucketPointer = typename std::allocator_traits<Allocator>::template rebind_traits<Bucket>::pointer;
+                using ChunkAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<BucketPointer>;
+                using ChunkPointer = typename std::allocator_traits<ChunkAllocator>::pointer;
+
+            public:
+                explicit Directory(const Allocator& allocator)
+                    : m_allocator{ allocator }
+                {}
+
+                Directory(const Directory& other) = delete;
+                Directory& operator=(const Directory& other) = delete;
+
+                ~Directory()
+                {
+                    for (Index i = 0; i < m_chunks.size(); ++i)
+                    {
+                        if (auto& chunk = m_chunks[i])
+                        {
+                            std::allocator_traits<ChunkAllocator>::deallocate(m_allocator, chunk, Index{ 1 } << i);
+                        }
+                    }
+                }
+
+                Bucket* operator[](Index index) const
+                {
+                    if (index < m_size.load(std::memory_order_acquire))
+                    {
+                        auto chunk = Log2(index + 1);
+                        return std::addressof(*m_chunks[chunk][index + 1 - (Index{ 1 } << chunk)]);
+                    }
+
+                    return nullptr;
+                }
+
+                void Add(Bucket& bucket)
+                {
+                    auto index = m_size.load(std::memory_order_relaxed);
+                    auto chunk = Log2(index + 1);
+                    auto offset = index + 1 - (Index{ 1 } << chunk);
+
+                    if (offset == 0)
+                    {
+                        m_chunks[chunk] = std::allocator_traits<ChunkAllocator>::allocate(m_allocator, Index{ 1 } << chunk);
+                    }
+
+                    std::allocator_traits<ChunkAllocator>::construct(
+                        m_allocator, std::addressof(m_chunks[chunk][offset]), std::pointer_traits<BucketPointer>::pointer_to(bucket));
+
+                    m_size.store(index + 1, std::memory_order_release);
+                }
+
+            private:
+                static Index Log2(Index value)
+                {
+                    unsigned long result;
+                    _BitScanReverse(&result, value);
+                    return static_cast<Index>(result);
+                }
+
+                ChunkAllocator m_allocator;
+                std::array<ChunkPointer, 32> m_chunks{};
+                std::atomic_uint32_t m_size{ 0 };
+            };
+
+
             typename Bucket::Item* Get(Index index)
             {
-                typename Bucket::Item* item{ nullptr };
+                auto bucket = m_directory[index / BucketSize];
+
+                return bucket ? (*bucket)[index % BucketSize] : nullptr;
+            }
 
-                auto search = [&item, i = Index{}, itemIndex = index % BucketSize, bucketIndex = index / BucketSize](auto& bucket) mutable
+            /// Free objects form a stack linked by indices. The head also carries
+            /// a tag which changes on every update to avoid the ABA problem.
+            static constexpr Index c_nullIndex = (std::numeric_limits<Index>::max)();
+
+            static constexpr std::uint64_t MakeFreeHead(Index index, std::uint64_t tag)
+            {
+                return (tag << 32) | index;
+            }
+
+            boost::optional<std::pair<typename Bucket::Item&, Index>> PopFree()
+            {
+                for (auto head = m_freeHead.load(std::memory_order_acquire); ; )
                 {
-                    if (i == bucketIndex)
+                    auto index = static_cast<Index>(head);
+
+                    if (index == c_nullIndex)
                     {
-                        item = bucket[itemIndex];
-                        return true;
+                        return{};
                     }
 
-                    ++i;
-                    return false;
-                };
+                    auto item = Get(index);
+                    assert(item);
+
+                    if (m_freeHead.compare_exchange_weak(
+                        head, MakeFreeHead(item->GetNextFree().load(std::memory_order_relaxed), (head >> 32) + 1), std::memory_order_acquire))
+                    {
+                        return std::pair<typename Bucket::Item&, Index>{ *item, index };
+                    }
+                }
+            }
 
-                return m_buckets.TryApply(search) ? item : nullptr;
+            void PushFree(typename Bucket::Item& item, Index index)
+            {
+                auto head = m_freeHead.load(std::memory_order_relaxed);
+
+                do
+                {
+                    item.GetNextFree().store(static_cast<Index>(head), std::memory_order_relaxed);
+                }
+                while (!m_freeHead.compare_exchange_weak(head, MakeFreeHead(index, (head >> 32) + 1), std::memory_order_release, std::memory_order_relaxed));
             }
 
             template <typename... Args>
@@ -205,6 +350,14 @@ namespace IPC
                     [&, i = Index{}](auto& bucket) mutable
                     {
                         result = bucket.Construct(i++ * BucketSize, std::forward<decltype(args)>(args)...);  // TODO: Use Args when VC14 bugs are fixed.
+
+                        if (result.first && result.second % BucketSize == 0 && result.second != 0)
+                        {
+                            // The first object of a new bucket is always constructed under the growth lock
+                            // before the bucket is linked, so it is registered before anyone can use it.
+                            m_directory.Add(bucket);
+                        }
+
                         return result.first != nullptr;
                     });
 
@@ -220,7 +373,8 @@ namespace IPC
 
 
             ContainerList<Bucket, Allocator> m_buckets;
-            Queue<Index, Allocator, BucketSize> m_pool;
+            Directory m_directory;
+            std::atomic_uint64_t m_freeHead{ MakeFreeHead(c_nullIndex, 0) };
         };
 
     } // LockFree
@@ -3,6 +3,7 @@
 #include "QueueFwd.h"
 #include "FixedQueue.h"
 #include "ContainerList.h"
+#include <iterator>
 #include <new>
 
 #pragma warning(push)
@@ -18,15 +19,22 @@ namespace IPC
     {
         /// Provides a multi-reader/multi-writer queue with dynamically growing capacity
         /// where pushing and popping is lock-free and capacity growth is synchronized.
-        /// Supports any element type. Can also be allocated directly in shared memory
-        /// as along as T has same capability.
+        /// When constructed as reclaimable, idle buckets are released after consuming when the
+        /// queue shrinks back, at the cost of registering every access in counters shared by all
+        /// producers and consumers. Supports any element type. Can also be allocated directly
+        /// in shared memory as along as T has same capability.
         template <typename T, typename Allocator, std::size_t BucketSize>
         class Queue
         {
         public:
-            explicit Queue(const Allocator& allocator)
+            explicit Queue(const Allocator& allocator, bool reclaimable = false)
                 : m_queues{ allocator }
-            {}
+            {
+                if (reclaimable)
+                {
+                    m_queues.EnableReclamation();
+                }
+            }
 
             bool IsEmpty() const
             {
@@ -51,6 +59,44 @@ namespace IPC
                 }
             }
 
+            /// Pushes a prefix of the range filling up the existing buckets first.
+            /// Returns the number of elements pushed. Elements past that are not moved out.
+            /// When a constructor throws after some elements were already pushed, the push
+            /// stops there and returns their count, so pushing the rest rethrows the error.
+            template <typename Iterator>
+            std::size_t Push(Iterator first, Iterator last)
+            {
+                std::size_t count{ 0 };
+
+                try
+                {
+                    while (first != last)
+                    {
+                        m_queues.Apply(
+                            [&](auto& queue)
+                            {
+                                auto n = queue.Push(first, last);
+                                std::advance(first, n);
+                                count += n;
+                                return n != 0;
+                            });
+                    }
+                }
+                catch (const boost::interprocess::bad_alloc& /*e*/)
+                {}
+                catch (const std::bad_alloc& /*e*/)
+                {}
+                catch (...)
+                {
+                    if (count == 0)
+                    {
+                        throw;
+                    }
+                }
+
+                return count;
+            }
+
             boost::optional<T> Pop()
             {
                 boost::optional<T> result;
@@ -64,14 +110,23 @@ namespace IPC
             std::size_t ConsumeAll(Function&& func)
             {
                 std::size_t count{ 0 };
+                std::size_t bucketCount{ 0 };
+
+                m_queues.TryApply([&](auto& queue) { count += queue.ConsumeAll(func); ++bucketCount; return false; });
 
-                m_queues.TryApply([&](auto& queue) { count += queue.ConsumeAll(func); return false; });
+                // A pending trim may hide buckets filled by a writer, so it is finished even when one is visible.
+                if (m_queues.IsReclaimable() && (bucketCount > 1 || m_queues.IsTrimPending()))
+                {
+                    // Release at most half of the buckets at a time so that a steady load
+                    // at a bucket boundary does not keep reallocating the same bucket.
+                    m_queues.Trim([](const auto& queue) { return queue.IsEmpty(); }, (bucketCount + 1) / 2);
+                }
 
                 return count;
             }
 
         private:
-            ContainerList<FixedQueue<T, BucketSize>, Allocator> m_queues;
+            ContainerList<FixedQueue<T, BucketSize>, Allocator, true> m_queues;
         };
 
     } // LockFree
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <cassert>
+
+#pragma warning(push)
+#include <boost/optional.hpp>
+#pragma warning(pop)
+
+
+namespace IPC
+{
+    namespace detail
+    {
+    namespace LockFree
+    {
+        /// Provides a single-reader/single-writer queue with a compile-time fixed capacity
+        /// where pushing and popping is wait-free. Supports any element type. Can also be
+        /// allocated directly in shared memory as along as T has same capability.
+        /// At most one thread may push and at most one thread may pop at any given time.
+        template <typename T, typename Allocator, std::size_t Capacity = 1024>
+        class RingQueue
+        {
+            static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2.");
+
+        public:
+            explicit RingQueue(const Allocator& /*allocator*/ = {})
+            {}
+
+            RingQueue(const RingQueue& other) = delete;
+            RingQueue& operator=(const RingQueue& other) = delete;
+
+            ~RingQueue()
+            {
+                for (auto head = m_reader.m_index.load(std::memory_order_relaxed),
+                        tail = m_writer.m_index.load(std::memory_order_relaxed); head != tail; ++head)
+                {
+                    Destroy(head);
+                }
+            }
+
+            bool IsEmpty() const
+            {
+                return m_reader.m_index.load(std::memory_order_acquire) == m_writer.m_index.load(std::memory_order_acquire);
+            }
+
+            template <typename U>
+            bool Push(U&& value)
+            {
+                auto tail = m_writer.m_index.load(std::memory_order_relaxed);
+
+                if (tail - m_writer.m_cachedIndex == Capacity)
+                {
+                    m_writer.m_cachedIndex = m_reader.m_index.load(std::memory_order_acquire);   // Refresh the stale reader position.
+
+                    if (tail - m_writer.m_cachedIndex == Capacity)
+                    {
+                        return false;
+                    }
+                }
+
+                new (&m_storage[tail & c_mask]) T(std::forward<U>(value));
+
+                m_writer.m_index.store(tail + 1, std::memory_order_release);
+
+                return true;
+            }
+
+            /// Pushes a prefix of the range and publishes it with a single position update.
+            /// Returns the number of elements pushed. Elements past that are not moved out.
+            /// When a constructor throws nothing is pushed.
+            template <typename Iterator>
+            std::size_t Push(Iterator first, Iterator last)
+            {
+                auto size = static_cast<std::size_t>(std::distance(first, last));
+                auto tail = m_writer.m_index.load(std::memory_order_relaxed);
+
+                if (tail - m_writer.m_cachedIndex + size > Capacity)
+                {
+                    m_writer.m_cachedIndex = m_reader.m_index.load(std::memory_order_acquire);   // Refresh the stale reader position.
+                }
+
+                auto count = (std::min)(size, Capacity - (tail - m_writer.m_cachedIndex));
+                std::size_t i = 0;
+
+                try
+                {
+                    for (; i != count; ++i, ++first)
+                    {
+                        new (&m_storage[(tail + i) & c_mask]) T(*first);
+                    }
+                }
+                catch (...)
+                {
+                    while (i != 0)
+                    {
+                        Destroy(tail + --i);    // Nothing is published yet.
+                    }
+
+                    throw;
+                }
+
+                m_writer.m_index.store(tail + count, std::memory_order_release);
+
+                return count;
+            }
+
+            boost::optional<T> Pop()
+            {
+                boost::optional<T> value;
+
+                auto head = m_reader.m_index.load(std::memory_order_relaxed);
+
+                if (IsReadable(head))
+                {
+                    Consume(head, [&](T&& obj) { value = std::move(obj); });
+                }
+
+                return value;
+            }
+
+            template <typename Function>
+            std::size_t ConsumeAll(Function&& func)
+            {
+                std::size_t count{ 0 };
+
+                for (auto head = m_reader.m_index.load(std::memory_order_relaxed); IsReadable(head); ++head, ++count)
+                {
+                    Consume(head, func);
+                }
+
+                return count;
+            }
+
+        private:
+            static constexpr std::size_t c_mask = Capacity - 1;
+            static constexpr std::size_t c_cacheLineSize = 64;
+
+            // Padding is used instead of alignas since shared memory allocations do not honor extended alignment.
+            struct Position
+            {
+                std::atomic_size_t m_index{ 0 };
+                std::size_t m_cachedIndex{ 0 };     // Last observed index of the opposite side, owned by this side.
+                char m_padding[c_cacheLineSize - sizeof(std::atomic_size_t) - sizeof(std::size_t)];
+            };
+
+            bool IsReadable(std::size_t head)
+            {
+                if (head == m_reader.m_cachedIndex)
+                {
+                    m_reader.m_cachedIndex = m_writer.m_index.load(std::memory_order_acquire);     // Refresh the stale writer position.
+                }
+
+                return head != m_reader.m_cachedIndex;
+            }
+
+            template <typename Function>
+            void Consume(std::size_t head, Function&& func)
+            {
+                auto release = [&]
+                {
+                    Destroy(head);
+                    m_reader.m_index.store(head + 1, std::memory_order_release);
+                };
+
+                try
+                {
+                    func(std::move(*reinterpret_cast<T*>(&m_storage[head & c_mask])));
+                }
+                catch (...)
+                {
+                    release();
+                    throw;
+                }
+
+                release();
+            }
+
+            void Destroy(std::size_t index)
+            {
+                auto obj = reinterpret_cast<T*>(&m_storage[index & c_mask]);
+                obj->~T();
+                (void)obj;
+            }
+
+
+            char m_padding[c_cacheLineSize];    // Keep the hot positions away from whatever precedes the queue.
+            Position m_reader;
+            Position m_writer;
+            std::array<std::aligned_storage_t<sizeof(T), alignof(T)>, Capacity> m_storage;
+        };
+
+    } // LockFree
+    } // detail
+} // IPC
@@ -0,0 +1,414 @@
+#pragma once
+
+#pragma warning(push)
+#include <boost/interprocess/allocators/allocator.hpp>
+#include <boost/interprocess/detail/utilities.hpp>
+#include <boost/intrusive/set.hpp>
+#include <boost/intrusive/unordered_set.hpp>
+#include <boost/intrusive/pointer_traits.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#pragma warning(pop)
+
+#include "Alias.h"
+#include <string>
+#include <utility>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+
+namespace IPC
+{
+    namespace detail
+    {
+        /// Named object index of a managed segment which is either an intrusive red-black tree,
+        /// same as ipc::iset_index, or an intrusive hash table, same as ipc::iunordered_set_index.
+        /// Every entry carries the hooks of both. The mode is taken from HasHashedIndex of the
+        /// memory algorithm, so it is shared by all processes and must be selected while the
+        /// index is empty. Hashed lookups do not depend on the number of named objects at the
+        /// cost of a bucket array which is reallocated as the index grows.
+        template <typename MapConfig>
+        class SelectableIndex
+        {
+            using SegmentManagerBase = typename MapConfig::segment_manager_base;
+            using MemoryAlgorithm = typename SegmentManagerBase::memory_algorithm;
+            using VoidPointer = typename SegmentManagerBase::void_pointer;
+            using CharType = typename MapConfig::char_type;
+            using Key = typename MapConfig::intrusive_compare_key_type;
+
+            struct TreeTag;
+            struct TableTag;
+
+            using TreeHook = typename boost::intrusive::make_set_base_hook<
+                boost::intrusive::void_pointer<VoidPointer>,
+                boost::intrusive::tag<TreeTag>,
+                boost::intrusive::optimize_size<true>>::type;
+
+            using TableHook = typename boost::intrusive::make_unordered_set_base_hook<
+                boost::intrusive::void_pointer<VoidPointer>,
+                boost::intrusive::tag<TableTag>,
+                boost::intrusive::store_hash<true>>::type;
+
+            struct Hook : TreeHook, TableHook
+            {};
+
+        public:
+            using value_type = typename MapConfig::template intrusive_value_type<Hook>::type;
+            using size_type = typename SegmentManagerBase::size_type;
+
+        private:
+            template <typename Value>
+            class Iterator : public boost::iterator_facade<Iterator<Value>, Value, boost::forward_traversal_tag>
+            {
+            public:
+                Iterator() = default;
+
+                Iterator(const SelectableIndex* index, Value* value)
+                    : m_index{ index },
+                      m_value{ value }
+                {}
+
+                template <typename Other, typename = std::enable_if_t<std::is_convertible<Other*, Value*>::value>>
+                Iterator(const Iterator<Other>& other)
+                    : m_index{ other.m_index },
+                      m_value{ other.m_value }
+                {}
+
+            private:
+                friend class boost::iterator_core_access;
+
+                template <typename Other>
+                friend class Iterator;
+
+                Value& dereference() const
+                {
+                    return *m_value;
+                }
+
+                template <typename Other>
+                bool equal(const Iterator<Other>& other) const
+                {
+                    return m_value == other.m_value;
+                }
+
+                void increment()
+                {
+                    m_value = m_index->Next(*m_value);
+                }
+
+
+                const SelectableIndex* m_index{ nullptr };
+                Value* m_value{ nullptr };     // Null for the end.
+            };
+
+            struct Less
+            {
+                bool operator()(const Key& key, const value_type& value) const
+                {
+                    std::size_t length = value.name_length();
+                    return key.m_len < length
+                        || (key.m_len == length && std::char_traits<CharType>::compare(key.mp_str, value.name(), length) < 0);
+                }
+
+                bool operator()(const value_type& value, const Key& key) const
+                {
+                    std::size_t length = value.name_length();
+                    return length < key.m_len
+                        || (length == key.m_len && std::char_traits<CharType>::compare(value.name(), key.mp_str, length) < 0);
+                }
+            };
+
+            struct Equal
+            {
+                bool operator()(const Key& key, const value_type& value) const
+                {
+                    return key.m_len == value.name_length()
+                        && std::char_traits<CharType>::compare(key.mp_str, value.name(), key.m_len) == 0;
+                }
+
+                bool operator()(const value_type& left, const value_type& right) const
+                {
+                    return left.name_length() == right.name_length()
+                        && std::char_traits<CharType>::compare(left.name(), right.name(), left.name_length()) == 0;
+                }
+            };
+
+            struct Hash
+            {
+                std::size_t operator()(const Key& key) const
+                {
+                    return HashName(key.mp_str, key.m_len);
+                }
+
+                std::size_t operator()(const value_type& value) const
+                {
+                    return HashName(value.name(), value.name_length());
+                }
+
+                /// Names share long prefixes of type names and versions, so all of the bytes are
+                /// mixed in, a word at a time.
+                static std::size_t HashName(const CharType* name, std::size_t length)
+                {
+                    auto data = reinterpret_cast<const unsigned char*>(name);
+                    auto size = length * sizeof(CharType);
+                    std::uint64_t hash = 14695981039346656037ull;
+
+                    for (; size >= sizeof(std::uint64_t); data += sizeof(std::uint64_t), size -= sizeof(std::uint64_t))
+                    {
+                        std::uint64_t word;
+                        std::memcpy(&word, data, sizeof(word));
+                        hash = (hash ^ word) * 1099511628211ull;
+                        hash ^= hash >> 32;
+                    }
+
+                    for (; size != 0; ++data, --size)
+                    {
+                        hash = (hash ^ *data) * 1099511628211ull;
+                    }
+
+                    return static_cast<std::size_t>(hash ^ (hash >> 29));
+                }
+            };
+
+            using Tree = typename boost::intrusive::make_set<
+                value_type,
+                boost::intrusive::base_hook<TreeHook>,
+                boost::intrusive::size_type<size_type>>::type;
+
+            using Table = typename boost::intrusive::make_unordered_set<
+                value_type,
+                boost::intrusive::base_hook<TableHook>,
+                boost::intrusive::hash<Hash>,
+                boost::intrusive::equal<Equal>,
+                boost::intrusive::size_type<size_type>>::type;
+
+            using Bucket = typename Table::bucket_type;
+            using BucketPointer = typename Table::bucket_ptr;
+            using BucketTraits = typename Table::bucket_traits;
+            using BucketAllocator = ipc::allocator<Bucket, SegmentManagerBase>;
+
+            using SegmentPointer = typename boost::intrusive::pointer_traits<VoidPointer>::template rebind_pointer<SegmentManagerBase>::type;
+
+        public:
+            using iterator = Iterator<value_type>;
+            using const_iterator = Iterator<const value_type>;
+
+            struct insert_commit_data
+            {
+                typename Tree::insert_commit_data m_tree;
+                typename Table::insert_commit_data m_table;
+            };
+
+            explicit SelectableIndex(SegmentManagerBase* segment)
+                : m_segment{ segment },
+                  m_table{ BucketTraits{ BucketPointer{ &m_initialBucket }, 1 } }
+            {}
+
+            SelectableIndex(const SelectableIndex& other) = delete;
+            SelectableIndex& operator=(const SelectableIndex& other) = delete;
+
+            ~SelectableIndex()
+            {
+                m_tree.clear();
+                m_table.clear();
+                shrink_to_fit();
+            }
+
+            iterator begin()
+            {
+                return{ this, First() };
+            }
+
+            const_iterator begin() const
+            {
+                return{ this, First() };
+            }
+
+            iterator end()
+            {
+                return{ this, nullptr };
+            }
+
+            const_iterator end() const
+            {
+                return{ this, nullptr };
+            }
+
+            size_type size() const
+            {
+                return IsHashed() ? m_table.size() : m_tree.size();
+            }
+
+            iterator find(const Key& key)
+            {
+                return{ this, Find(key) };
+            }
+
+            const_iterator find(const Key& key) const
+            {
+                return{ this, Find(key) };
+            }
+
+            std::pair<iterator, bool> insert_check(const Key& key, insert_commit_data& data)
+            {
+                if (IsHashed())
+                {
+                    auto result = m_table.insert_check(key, Hash{}, Equal{}, data.m_table);
+                    return{ result.second ? end() : iterator{ this, &*result.first }, result.second };
+                }
+
+                auto result = m_tree.insert_check(key, Less{}, data.m_tree);
+                return{ result.second ? end() : iterator{ this, &*result.first }, result.second };
+            }
+
+            iterator insert_commit(value_type& value, insert_commit_data& data)
+            {
+                if (!IsHashed())
+                {
+                    m_tree.insert_commit(value, data.m_tree);
+                }
+                else
+                {
+                    auto it = m_table.insert_commit(value, data.m_table);
+
+                    try
+                    {
+                        reserve(m_table.size());    // Keeps the load factor at one.
+                    }
+                    catch (...)
+                    {
+                        m_table.erase(it);
+                        throw;
+                    }
+                }
+
+                return{ this, &value };
+            }
+
+            void erase(iterator it)
+            {
+                if (IsHashed())
+                {
+                    m_table.erase(m_table.iterator_to(*it));
+                }
+                else
+                {
+                    m_tree.erase(m_tree.iterator_to(*it));
+                }
+            }
+
+            void reserve(size_type count)
+            {
+                if (!IsHashed() || count <= m_table.bucket_count())
+                {
+                    return;
+                }
+
+                count = Table::suggested_upper_bucket_count(count);
+
+                BucketAllocator allocator{ ipc::ipcdetail::to_raw_pointer(m_segment) };
+                auto buckets = allocator.allocate(count);
+
+                for (size_type i = 0; i != count; ++i)
+                {
+                    new (&buckets[i]) Bucket{};
+                }
+
+                auto oldBuckets = m_table.bucket_pointer();
+                auto oldCount = m_table.bucket_count();
+
+                m_table.rehash(BucketTraits{ buckets, count });
+                FreeBuckets(oldBuckets, oldCount);
+            }
+
+            void shrink_to_fit()
+            {
+                if (m_table.empty())
+                {
+                    auto buckets = m_table.bucket_pointer();
+                    auto count = m_table.bucket_count();
+
+                    m_table.rehash(BucketTraits{ BucketPointer{ &m_initialBucket }, 1 });
+                    FreeBuckets(buckets, count);
+                }
+            }
+
+        private:
+            bool IsHashed() const
+            {
+                // The memory algorithm is a private base of the segment manager.
+                return ((const MemoryAlgorithm&)*m_segment).HasHashedIndex();
+            }
+
+            value_type* ToPointer(const value_type& value) const
+            {
+                return const_cast<value_type*>(&value);
+            }
+
+            value_type* First() const
+            {
+                if (IsHashed())
+                {
+                    return m_table.empty() ? nullptr : ToPointer(*m_table.begin());
+                }
+
+                return m_tree.empty() ? nullptr : ToPointer(*m_tree.begin());
+            }
+
+            value_type* Next(const value_type& value) const
+            {
+                if (IsHashed())
+                {
+                    auto it = m_table.iterator_to(value);
+                    return ++it == m_table.end() ? nullptr : ToPointer(*it);
+                }
+
+                auto it = m_tree.iterator_to(value);
+                return ++it == m_tree.end() ? nullptr : ToPointer(*it);
+            }
+
+            value_type* Find(const Key& key) const
+            {
+                if (IsHashed())
+                {
+                    auto it = m_table.find(key, Hash{}, Equal{});
+                    return it == m_table.end() ? nullptr : ToPointer(*it);
+                }
+
+                auto it = m_tree.find(key, Less{});
+                return it == m_tree.end() ? nullptr : ToPointer(*it);
+            }
+
+            /// Releases a bucket array which is no longer used by the table.
+            void FreeBuckets(BucketPointer buckets, size_type count)
+            {
+                if (buckets != BucketPointer{ &m_initialBucket })
+                {
+                    BucketAllocator{ ipc::ipcdetail::to_raw_pointer(m_segment) }.deallocate(buckets, count);
+                }
+            }
+
+
+            SegmentPointer m_segment;
+            Tree m_tree;
+            Bucket m_initialBucket;
+            Table m_table;
+        };
+
+    } // detail
+} // IPC
+
+
+namespace boost
+{
+    namespace interprocess
+    {
+        template <typename MapConfig>
+        struct is_intrusive_index<IPC::detail::SelectableIndex<MapConfig>>
+        {
+            static const bool value = true;
+        };
+
+    } // interprocess
+} // boost
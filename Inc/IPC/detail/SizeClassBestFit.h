@@ -0,0 +1,558 @@
+#pragma once
+
+#pragma warning(push)
+#include <boost/interprocess/mem_algo/rbtree_best_fit.hpp>
+#include <boost/intrusive/set.hpp>
+#pragma warning(pop)
+
+#include "Alias.h"
+#include <array>
+#include <atomic>
+#include <algorithm>
+#include <new>
+#include <limits>
+#include <cstdint>
+#include <climits>
+#include <cassert>
+
+
+namespace IPC
+{
+    namespace detail
+    {
+        /// Commits reserved pages of the calling process' view. Returns false on failure.
+        bool CommitMemory(void* address, std::size_t size);
+
+
+        /// Memory algorithm which keeps freed small blocks in lock-free per size class lists
+        /// and reuses them without taking the allocator lock. Larger blocks and list refills
+        /// go to the rbtree_best_fit base, and the lists are returned to it when it runs out
+        /// of memory. Behaves exactly as the base until EnableSizeClasses is called.
+        /// Blocks are linked in chains so that a whole batch is moved with a single update.
+        /// When EnableGrowth is called the memory grows into reserved pages instead of failing.
+        /// Also keeps the index mode of the segment since the indexes cannot store options.
+        template <typename MutexFamily>
+        class SizeClassBestFit : public ipc::rbtree_best_fit<MutexFamily>
+        {
+            using Base = ipc::rbtree_best_fit<MutexFamily>;
+
+        public:
+            using typename Base::size_type;
+
+            static constexpr std::size_t c_classCount = 16;
+            static constexpr size_type c_maxClassSize = 4096;
+
+            SizeClassBestFit(size_type size, size_type extraHeaderBytes)
+                : Base{ size, extraHeaderBytes + GetExtraHeaderBytes() }   // Keep the base from handing out the members below.
+            {}
+
+            static size_type get_min_size(size_type extraHeaderBytes)
+            {
+                return Base::get_min_size(extraHeaderBytes + GetExtraHeaderBytes());
+            }
+
+            /// Must be called before the memory is shared with other threads or processes.
+            void EnableSizeClasses()
+            {
+                assert((std::max)(Base::get_size(), m_maxSize) / c_offsetUnit <= (std::numeric_limits<std::uint32_t>::max)());
+                assert(c_classSizes.back() == c_maxClassSize);
+                m_enabled = true;
+            }
+
+            bool IsSizeClassesEnabled() const
+            {
+                return m_enabled;
+            }
+
+            /// Marks the memory as served through per-thread caches on top of the size classes,
+            /// see SharedMemory::Allocator. Must be called before the memory is shared.
+            void EnableThreadCaching()
+            {
+                EnableSizeClasses();
+                m_threadCaching = true;
+            }
+
+            bool IsThreadCachingEnabled() const
+            {
+                return m_threadCaching;
+            }
+
+            /// Makes the named object indexes of the segment hashed, see detail::SelectableIndex.
+            /// Must be called before any object is named and the memory is shared.
+            void EnableHashedIndex()
+            {
+                m_hashedIndex = true;
+            }
+
+            bool HasHashedIndex() const
+            {
+                return m_hashedIndex;
+            }
+
+            /// Allows the memory to grow up to maxSize bytes from the beginning of this object by
+            /// committing more pages when an allocation fails. The address range must be reserved
+            /// in every process. Must be called before the memory is shared.
+            void EnableGrowth(size_type maxSize)
+            {
+                assert(maxSize >= Base::get_size());
+                m_maxSize = maxSize;
+            }
+
+            size_type GetMaxSize() const
+            {
+                return (std::max)(m_maxSize, Base::get_size());
+            }
+
+            /// Returns the number of freed bytes kept in the size class lists.
+            size_type GetCachedSize() const
+            {
+                return m_cachedBytes.load(std::memory_order_relaxed);
+            }
+
+            /// Returns the maximum number of bytes taken from the base since creation, including
+            /// the cached ones. Sampled on allocation without the lock, so it is approximate.
+            size_type GetHighWaterMark() const
+            {
+                return m_highWaterMark.load(std::memory_order_relaxed);
+            }
+
+            /// Invokes func with the size of every free block of the base, not including the size
+            /// class lists. Holds the base lock for time linear in the number of free blocks.
+            template <typename Function>
+            void ForEachFreeBlock(Function&& func) const
+            {
+                auto& header = GetBaseHeader();
+                ipc::scoped_lock<typename MutexFamily::mutex_type> guard{ header };
+
+                for (auto& block : header.m_freeBlocks)
+                {
+                    func(static_cast<size_type>(block.m_size) * Base::Alignment);
+                }
+            }
+
+            /// Returns the class serving allocations of the given size or c_classCount if there is none.
+            static std::size_t GetAllocationClass(size_type nbytes)
+            {
+                return static_cast<std::size_t>(
+                    std::lower_bound(c_classSizes.begin(), c_classSizes.end(), nbytes) - c_classSizes.begin());
+            }
+
+            static size_type GetClassSize(std::size_t index)
+            {
+                return c_classSizes[index];
+            }
+
+            /// Returns the class a freed block is cached in or c_classCount if it goes to the base.
+            std::size_t GetBlockClass(const void* addr) const
+            {
+                auto size = Base::size(addr);
+
+                return size >= c_classSizes.front() && size <= c_classSizes.back() + c_maxSlack
+                    ? static_cast<std::size_t>(std::upper_bound(c_classSizes.begin(), c_classSizes.end(), size) - c_classSizes.begin()) - 1
+                    : c_classCount;
+            }
+
+            void* allocate(size_type nbytes)
+            {
+                if (m_enabled && nbytes <= c_maxClassSize)
+                {
+                    auto index = GetAllocationClass(nbytes);
+
+                    if (auto ptr = Pop(index))
+                    {
+                        return ptr;
+                    }
+
+                    nbytes = c_classSizes[index];   // Round up so that the block can be reused by the whole class.
+                }
+
+                return AllocateFromBase(nbytes);
+            }
+
+            template <typename T>
+            T* allocation_command(
+                ipc::allocation_type command, size_type limitSize, size_type& preferInRecvdOutSize, T*& reuse)
+            {
+                auto preferredSize = preferInRecvdOutSize;
+                auto ptr = Base::allocation_command(command, limitSize, preferInRecvdOutSize, reuse);
+
+                if (!ptr && (command & ipc::allocate_new) && Grow(preferredSize * sizeof(T)))
+                {
+                    preferInRecvdOutSize = preferredSize;
+                    ptr = Base::allocation_command(command, limitSize, preferInRecvdOutSize, reuse);
+                }
+
+                if (ptr)
+                {
+                    UpdateHighWaterMark();
+                }
+
+                return ptr;
+            }
+
+            void deallocate(void* addr)
+            {
+                if (m_enabled && addr)
+                {
+                    auto index = GetBlockClass(addr);
+
+                    if (index != c_classCount)
+                    {
+                        Push(index, addr);
+                        return;
+                    }
+                }
+
+                Base::deallocate(addr);
+            }
+
+            /// Takes up to count blocks of the class and refills from the base when the list
+            /// runs dry. Returns the number of blocks stored in ptrs, zero if out of memory.
+            std::size_t PopBatch(std::size_t index, void** ptrs, std::size_t count)
+            {
+                std::size_t n = 0;
+                size_type bytes = 0;
+
+                while (n != count)
+                {
+                    auto ptr = PopChain(index);
+
+                    if (!ptr)
+                    {
+                        break;
+                    }
+
+                    for (; ptr && n != count; ++n)
+                    {
+                        ptrs[n] = ptr;
+                        bytes += GetBlockSize(ptr);
+
+                        auto next = GetChain(ptr);
+                        ptr = next != 0 ? FromOffset(next) : nullptr;
+                    }
+
+                    if (ptr)
+                    {
+                        PushChain(index, ptr, 0);   // Put back the rest of the chain, its bytes are still cached.
+                    }
+                }
+
+                if (bytes != 0)
+                {
+                    m_cachedBytes.fetch_sub(bytes, std::memory_order_relaxed);
+                }
+
+                for (; n != count; ++n)
+                {
+                    if (!(ptrs[n] = Base::allocate(c_classSizes[index])))
+                    {
+                        if (n == 0)
+                        {
+                            n += ((ptrs[n] = AllocateFromBase(c_classSizes[index])) != nullptr);
+                        }
+
+                        break;
+                    }
+                }
+
+                UpdateHighWaterMark();
+
+                return n;
+            }
+
+            /// Returns count blocks of the same class with a single list update.
+            void PushBatch(std::size_t index, void* const* ptrs, std::size_t count)
+            {
+                if (count == 0)
+                {
+                    return;
+                }
+
+                size_type bytes = 0;
+
+                for (std::size_t i = 0; i != count; ++i)
+                {
+                    GetChain(ptrs[i]) = i + 1 != count ? ToOffset(ptrs[i + 1]) : 0;
+                    bytes += GetBlockSize(ptrs[i]);
+                }
+
+                PushChain(index, ptrs[0], bytes);
+            }
+
+            size_type get_free_memory() const
+            {
+                return Base::get_free_memory() + m_cachedBytes.load(std::memory_order_relaxed);
+            }
+
+            void shrink_to_fit()
+            {
+                Flush();
+                Base::shrink_to_fit();
+            }
+
+            bool all_memory_deallocated()
+            {
+                Flush();
+                return Base::all_memory_deallocated();
+            }
+
+            /// Returns all cached blocks to the base. Returns false if nothing was cached.
+            bool Flush()
+            {
+                bool flushed = false;
+
+                for (auto& head : m_heads)
+                {
+                    auto value = head.load(std::memory_order_acquire);
+
+                    while (GetOffset(value) != 0
+                        && !head.compare_exchange_weak(value, MakeHead(0, GetTag(value) + 1), std::memory_order_acquire))
+                    {}
+
+                    for (auto offset = GetOffset(value); offset != 0; )
+                    {
+                        auto chain = FromOffset(offset);
+                        offset = GetLink(chain).load(std::memory_order_relaxed);
+
+                        for (auto ptr = chain; ptr; flushed = true)
+                        {
+                            auto next = GetChain(ptr);
+
+                            m_cachedBytes.fetch_sub(GetBlockSize(ptr), std::memory_order_relaxed);
+                            Base::deallocate(ptr);
+
+                            ptr = next != 0 ? FromOffset(next) : nullptr;
+                        }
+                    }
+                }
+
+                return flushed;
+            }
+
+        private:
+            static constexpr size_type c_maxSlack = 64;     // Blocks returned by the base may be slightly larger than requested.
+            static constexpr std::size_t c_offsetUnit = 8;
+            static constexpr size_type c_growthSlack = 4096;   // Covers block headers and alignment of the grown region.
+
+            static const std::array<size_type, c_classCount> c_classSizes;
+
+            static constexpr size_type GetExtraHeaderBytes()
+            {
+                return sizeof(SizeClassBestFit) - sizeof(Base);
+            }
+
+            static std::uint64_t MakeHead(std::uint32_t offset, std::uint32_t tag)
+            {
+                return (std::uint64_t{ tag } << 32) | offset;
+            }
+
+            static std::uint32_t GetOffset(std::uint64_t head)
+            {
+                return static_cast<std::uint32_t>(head);
+            }
+
+            static std::uint32_t GetTag(std::uint64_t head)
+            {
+                return static_cast<std::uint32_t>(head >> 32);
+            }
+
+            static std::atomic<std::uint32_t>& GetLink(void* ptr)
+            {
+                return *static_cast<std::atomic<std::uint32_t>*>(ptr);
+            }
+
+            static std::uint32_t& GetChain(void* ptr)
+            {
+                return static_cast<std::uint32_t*>(ptr)[1];    // Next block of the same chain, follows the list link.
+            }
+
+            size_type GetBlockSize(const void* ptr) const
+            {
+                return Base::size(ptr) + Base::PayloadPerAllocation;
+            }
+
+            std::uint32_t ToOffset(const void* ptr) const
+            {
+                auto offset = static_cast<const char*>(ptr) - reinterpret_cast<const char*>(this);
+                assert(offset > 0 && offset % c_offsetUnit == 0);
+
+                return static_cast<std::uint32_t>(offset / c_offsetUnit);
+            }
+
+            void* FromOffset(std::uint32_t offset)
+            {
+                return reinterpret_cast<char*>(this) + std::size_t{ offset } * c_offsetUnit;
+            }
+
+            void* AllocateFromBase(size_type nbytes)
+            {
+                auto ptr = Base::allocate(nbytes);
+
+                if (!ptr && m_enabled && Flush())
+                {
+                    ptr = Base::allocate(nbytes);
+                }
+
+                if (!ptr && Grow(nbytes))
+                {
+                    ptr = Base::allocate(nbytes);
+                }
+
+                if (ptr)
+                {
+                    UpdateHighWaterMark();
+                }
+
+                return ptr;
+            }
+
+            void UpdateHighWaterMark()
+            {
+                auto used = Base::get_size() - Base::get_free_memory();
+                auto mark = m_highWaterMark.load(std::memory_order_relaxed);
+
+                while (used > mark && !m_highWaterMark.compare_exchange_weak(mark, used, std::memory_order_relaxed))
+                {}
+            }
+
+            /// Mirrors the private header of the base, which keeps free blocks in a tree by size.
+            struct BaseHeader : MutexFamily::mutex_type
+            {
+                struct SizeHolder
+                {
+                    size_type m_prevSize;
+                    size_type m_size : sizeof(size_type) * CHAR_BIT - 2;
+                    size_type m_prevAllocated : 1;
+                    size_type m_allocated : 1;
+                };
+
+                using Hook = typename boost::intrusive::make_set_base_hook<
+                    boost::intrusive::void_pointer<typename Base::void_pointer>,
+                    boost::intrusive::optimize_size<true>,
+                    boost::intrusive::link_mode<boost::intrusive::normal_link>>::type;
+
+                struct Block : SizeHolder, Hook
+                {};
+
+                typename boost::intrusive::make_multiset<Block, boost::intrusive::base_hook<Hook>>::type m_freeBlocks;
+                size_type m_extraHeaderBytes;
+                size_type m_allocated;
+                size_type m_size;
+            };
+
+            BaseHeader& GetBaseHeader() const
+            {
+                static_assert(sizeof(BaseHeader) == sizeof(Base), "Unexpected rbtree_best_fit layout.");
+
+                // The header is the only member of the base.
+                return *reinterpret_cast<BaseHeader*>(const_cast<Base*>(static_cast<const Base*>(this)));
+            }
+
+            /// Grows at least by nbytes and at most doubles the size. Returns false if at the limit.
+            bool Grow(size_type nbytes)
+            {
+                if (m_maxSize == 0)
+                {
+                    return false;
+                }
+
+                ipc::scoped_lock<typename MutexFamily::mutex_type> guard{ GetBaseHeader() };
+
+                auto size = Base::get_size();
+
+                if (size >= m_maxSize)
+                {
+                    return false;
+                }
+
+                auto extra = (std::min)(m_maxSize - size, (std::max)(size, nbytes + c_growthSlack));
+
+                if (!CommitMemory(reinterpret_cast<char*>(this) + size, extra))
+                {
+                    return false;
+                }
+
+                Base::grow(extra);
+
+                return true;
+            }
+
+            void* Pop(std::size_t index)
+            {
+                auto ptr = PopChain(index);
+
+                if (ptr)
+                {
+                    if (auto next = GetChain(ptr))
+                    {
+                        PushChain(index, FromOffset(next), 0);
+                    }
+
+                    m_cachedBytes.fetch_sub(GetBlockSize(ptr), std::memory_order_relaxed);
+                }
+
+                return ptr;
+            }
+
+            void Push(std::size_t index, void* ptr)
+            {
+                GetChain(ptr) = 0;
+                PushChain(index, ptr, GetBlockSize(ptr));
+            }
+
+            void* PopChain(std::size_t index)
+            {
+                auto& head = m_heads[index];
+
+                for (auto value = head.load(std::memory_order_acquire); GetOffset(value) != 0; )
+                {
+                    auto ptr = FromOffset(GetOffset(value));
+                    auto next = GetLink(ptr).load(std::memory_order_relaxed);     // May be stale, the tag check will fail then.
+
+                    if (head.compare_exchange_weak(value, MakeHead(next, GetTag(value) + 1), std::memory_order_acquire))
+                    {
+                        return ptr;
+                    }
+                }
+
+                return nullptr;
+            }
+
+            /// The chain links must already be set, bytes are the newly cached ones.
+            void PushChain(std::size_t index, void* ptr, size_type bytes)
+            {
+                auto& head = m_heads[index];
+                auto& link = *new (ptr) std::atomic<std::uint32_t>{ 0 };
+                auto offset = ToOffset(ptr);
+
+                if (bytes != 0)
+                {
+                    m_cachedBytes.fetch_add(bytes, std::memory_order_relaxed);
+                }
+
+                auto value = head.load(std::memory_order_relaxed);
+
+                do
+                {
+                    link.store(GetOffset(value), std::memory_order_relaxed);
+
+                } while (!head.compare_exchange_weak(value, MakeHead(offset, GetTag(value) + 1), std::memory_order_release));
+            }
+
+
+            bool m_enabled{ false };
+            bool m_threadCaching{ false };
+            bool m_hashedIndex{ false };
+            size_type m_maxSize{ 0 };
+            std::atomic_size_t m_cachedBytes{ 0 };
+            std::atomic_size_t m_highWaterMark{ 0 };
+            std::array<std::atomic<std::uint64_t>, c_classCount> m_heads{};
+        };
+
+
+        template <typename MutexFamily>
+        const std::array<typename SizeClassBestFit<MutexFamily>::size_type, SizeClassBestFit<MutexFamily>::c_classCount>
+            SizeClassBestFit<MutexFamily>::c_classSizes{
+                { 16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096 } };
+    } // detail
+} // IPC
@@ -1,24 +1,36 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 
 
 namespace IPC
 {
     namespace detail
     {
+        /// Spins for a while and then blocks on the lock word. Waiters in the unlocking process
+        /// are woken up immediately, the others recheck the lock word after a short timeout.
         class SpinLock
         {
         public:
             void lock();
 
+            bool try_lock();
+
             void unlock();
 
         private:
+            enum State : std::uint32_t
+            {
+                Unlocked,
+                Locked,
+                Contended   // Locked and there may be blocked waiters.
+            };
+
             static constexpr std::size_t c_maxYieldCount = 1000;
-            static constexpr std::size_t c_sleepDuration = 1;
+            static constexpr std::uint32_t c_waitTimeout = 1;
 
-            std::atomic_flag m_lock{ ATOMIC_FLAG_INIT };
+            std::atomic<std::uint32_t> m_state{ Unlocked };
         };
 
     } // detail
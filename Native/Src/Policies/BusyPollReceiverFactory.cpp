@@ -0,0 +1,208 @@
+#include "stdafx.h"
+#include "IPC/Policies/BusyPollReceiverFactory.h"
+#include "IPC/Exception.h"
+#include <vector>
+#include <algorithm>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+
+
+namespace IPC
+{
+namespace Policies
+{
+    class BusyPollReceiverFactory::Impl : public std::enable_shared_from_this<Impl>
+    {
+    public:
+        Impl(std::uint64_t affinityMask, Backoff backoff)
+            : m_affinityMask{ affinityMask },
+              m_backoff{ std::move(backoff) },
+              m_state{ std::make_shared<State>() }
+        {}
+
+        ~Impl()
+        {
+            m_state->m_stop = true;
+
+            if (m_thread.joinable())
+            {
+                if (m_thread.get_id() != std::this_thread::get_id())
+                {
+                    m_thread.join();
+                }
+                else
+                {
+                    m_thread.detach();  // Released from a handler, the thread exits after it returns.
+                }
+            }
+        }
+
+        std::shared_ptr<void> Poll(detail::Callback<std::size_t()> func)
+        {
+            auto entry = std::make_shared<Entry>(std::move(func));
+            {
+                std::lock_guard<std::mutex> guard{ m_state->m_lock };
+
+                if (!m_thread.joinable())
+                {
+                    Start();
+                }
+
+                m_state->m_entries.push_back(entry);
+                ++m_state->m_version;
+            }
+
+            return{ (void*) true, [impl = shared_from_this(), entry = std::move(entry)](void*) { impl->Remove(entry); } };
+        }
+
+    private:
+        struct Entry
+        {
+            explicit Entry(detail::Callback<std::size_t()> func)
+                : m_func{ std::move(func) }
+            {}
+
+            static constexpr std::uint32_t c_running = 1;     // Set by the polling thread around an invocation.
+            static constexpr std::uint32_t c_removed = 2;
+
+            detail::Callback<std::size_t()> m_func;
+            std::atomic_uint32_t m_flags{ 0 };
+        };
+
+        struct State
+        {
+            std::mutex m_lock;                          // Guards m_entries and m_threadId.
+            std::vector<std::shared_ptr<Entry>> m_entries;
+            std::atomic_size_t m_version{ 0 };
+            std::mutex m_runLock;                       // Only taken when an entry is removed during its invocation.
+            std::condition_variable m_runDone;
+            std::atomic_bool m_stop{ false };
+            std::thread::id m_threadId;
+        };
+
+
+        void Start()
+        {
+            std::thread thread{ [state = m_state, backoff = m_backoff] { Run(*state, backoff); } };
+
+            if (m_affinityMask != 0 && !::SetThreadAffinityMask(thread.native_handle(), static_cast<DWORD_PTR>(m_affinityMask)))
+            {
+                m_state->m_stop = true;
+                thread.join();
+                m_state->m_stop = false;
+
+                throw Exception{ "Failed to set the polling thread affinity." };
+            }
+
+            m_state->m_threadId = thread.get_id();
+            m_thread = std::move(thread);
+        }
+
+        void Remove(const std::shared_ptr<Entry>& entry)
+        {
+            bool isPollingThread;
+            {
+                std::lock_guard<std::mutex> guard{ m_state->m_lock };
+
+                auto& entries = m_state->m_entries;
+                entries.erase(std::find(entries.begin(), entries.end(), entry));
+                ++m_state->m_version;
+
+                isPollingThread = (m_state->m_threadId == std::this_thread::get_id());
+            }
+
+            if (isPollingThread)
+            {
+                entry->m_flags |= Entry::c_removed;     // Removed from a handler, the function is released with the snapshot.
+            }
+            else
+            {
+                if (entry->m_flags.fetch_or(Entry::c_removed) & Entry::c_running)
+                {
+                    std::unique_lock<std::mutex> guard{ m_state->m_runLock };   // Wait for the in-flight invocation.
+                    m_state->m_runDone.wait(guard, [&] { return (entry->m_flags & Entry::c_running) == 0; });
+                }
+
+                auto func = std::move(entry->m_func);   // Released once no invocation can be in flight.
+            }
+        }
+
+        static void Run(State& state, const Backoff& backoff)
+        {
+            std::vector<std::shared_ptr<Entry>> entries;
+            std::size_t version = state.m_version - 1;
+            std::uint64_t idle = 0;
+
+            while (!state.m_stop.load(std::memory_order_relaxed))
+            {
+                if (state.m_version != version)
+                {
+                    std::lock_guard<std::mutex> guard{ state.m_lock };
+                    entries = state.m_entries;
+                    version = state.m_version;
+                }
+
+                std::size_t count = 0;
+
+                for (auto& entry : entries)
+                {
+                    if ((entry->m_flags.fetch_or(Entry::c_running) & Entry::c_removed) == 0)
+                    {
+                        count += entry->m_func();
+                    }
+
+                    if (entry->m_flags.fetch_and(~Entry::c_running) & Entry::c_removed)
+                    {
+                        std::lock_guard<std::mutex> guard{ state.m_runLock };   // Remove may be waiting for this invocation.
+                        state.m_runDone.notify_all();
+                    }
+                }
+
+                if (count != 0)
+                {
+                    idle = 0;
+                }
+                else if (++idle <= backoff.m_spinCount)
+                {
+                    ::YieldProcessor();
+                }
+                else if (idle <= std::uint64_t{ backoff.m_spinCount } + backoff.m_yieldCount || backoff.m_sleepDuration.count() == 0)
+                {
+                    std::this_thread::yield();
+                }
+                else
+                {
+                    std::this_thread::sleep_for(backoff.m_sleepDuration);
+                }
+            }
+        }
+
+
+        const std::uint64_t m_affinityMask;
+        const Backoff m_backoff;
+        std::shared_ptr<State> m_state;     // Shared with the polling thread so it may outlive this object.
+        std::thread m_thread;
+    };
+
+
+    BusyPollReceiverFactory::BusyPollReceiverFactory()
+        : BusyPollReceiverFactory{ 0 }
+    {}
+
+    BusyPollReceiverFactory::BusyPollReceiverFactory(std::uint64_t affinityMask)
+        : BusyPollReceiverFactory{ affinityMask, {} }
+    {}
+
+    BusyPollReceiverFactory::BusyPollReceiverFactory(std::uint64_t affinityMask, Backoff backoff)
+        : m_impl{ std::make_shared<Impl>(affinityMask, std::move(backoff)) }
+    {}
+
+    std::shared_ptr<void> BusyPollReceiverFactory::Poll(detail::Callback<std::size_t()> func) const
+    {
+        return m_impl->Poll(std::move(func));
+    }
+
+} // Policies
+} // IPC
@@ -14,6 +14,18 @@ namespace Policies
     {
         m_stream << "IPC: ";
 
+        Write(std::move(error));
+    }
+
+    void ErrorHandler::operator()(std::exception_ptr error, std::size_t attempt) const
+    {
+        m_stream << "IPC: Reconnection attempt " << attempt << " failed: ";
+
+        Write(std::move(error));
+    }
+
+    void ErrorHandler::Write(std::exception_ptr error) const
+    {
         try
         {
             std::rethrow_exception(std::move(error));
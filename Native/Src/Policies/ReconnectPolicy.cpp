@@ -0,0 +1,49 @@
+#include "stdafx.h"
+#include "IPC/Policies/ReconnectPolicy.h"
+#include "IPC/Exception.h"
+#include <algorithm>
+#include <random>
+#include <cmath>
+
+
+namespace IPC
+{
+namespace Policies
+{
+    ReconnectPolicy::ReconnectPolicy(
+        const std::chrono::milliseconds& initialDelay,
+        const std::chrono::milliseconds& maxDelay,
+        double multiplier,
+        double jitter)
+        : m_initialDelay{ initialDelay },
+          m_maxDelay{ (std::max)(initialDelay, maxDelay) },
+          m_multiplier{ multiplier },
+          m_jitter{ jitter }
+    {
+        if (initialDelay <= std::chrono::milliseconds::zero() || multiplier < 1.0 || jitter < 0.0 || jitter > 1.0)
+        {
+            throw Exception{ "Invalid reconnect policy." };
+        }
+    }
+
+    std::chrono::milliseconds ReconnectPolicy::operator()(std::size_t failures) const
+    {
+        if (m_initialDelay == std::chrono::milliseconds::zero())
+        {
+            return m_initialDelay;
+        }
+
+        auto maxDelay = static_cast<double>(m_maxDelay.count());
+        auto delay = (std::min)(static_cast<double>(m_initialDelay.count()) * std::pow(m_multiplier, static_cast<double>(failures)), maxDelay);
+
+        if (m_jitter != 0.0)
+        {
+            thread_local std::minstd_rand s_engine{ std::random_device{}() };
+            delay -= std::uniform_real_distribution<double>{ 0.0, m_jitter * delay }(s_engine);
+        }
+
+        return std::chrono::milliseconds{ (std::max)(static_cast<std::chrono::milliseconds::rep>(delay), std::chrono::milliseconds::rep{ 1 }) };
+    }
+
+} // Policies
+} // IPC
@@ -116,9 +116,11 @@ namespace Policies
     }
 
 
-    TimeoutFactory::TimeoutFactory(const std::chrono::milliseconds& defaultTimeout, boost::optional<ThreadPool> pool)
+    TimeoutFactory::TimeoutFactory(
+        const std::chrono::milliseconds& defaultTimeout, boost::optional<ThreadPool> pool, ReconnectPolicy reconnectPolicy)
         : m_defaultTimeout{ defaultTimeout != std::chrono::milliseconds::zero() ? defaultTimeout : std::chrono::seconds{ 1 } },
-          m_pool{ std::move(pool) }
+          m_pool{ std::move(pool) },
+          m_reconnectPolicy{ std::move(reconnectPolicy) }
     {}
 
     auto TimeoutFactory::operator()(detail::Callback<void()> handler) const -> Scheduler
@@ -126,5 +128,10 @@ namespace Policies
         return Scheduler{ std::make_shared<Timeout>(m_pool, std::move(handler), m_defaultTimeout) };
     }
 
+    auto TimeoutFactory::GetReconnectPolicy() const -> const ReconnectPolicy&
+    {
+        return m_reconnectPolicy;
+    }
+
 } // Policies
 } // IPC
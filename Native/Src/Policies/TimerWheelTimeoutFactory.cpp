@@ -0,0 +1,402 @@
+#include "stdafx.h"
+#include "IPC/Policies/TimerWheelTimeoutFactory.h"
+#include "IPC/Exception.h"
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstdint>
+
+
+namespace IPC
+{
+namespace Policies
+{
+    class TimerWheelTimeoutFactory::Wheel
+    {
+    public:
+        /// Intrusive circular list link. A slot is an empty link pointing to itself.
+        struct Link
+        {
+            Link() = default;
+
+            Link(const Link& other) = delete;
+            Link& operator=(const Link& other) = delete;
+
+            bool IsLinked() const
+            {
+                return m_next != this;
+            }
+
+            void Unlink()
+            {
+                m_prev->m_next = m_next;
+                m_next->m_prev = m_prev;
+                m_prev = m_next = this;
+            }
+
+            void PushBack(Link& link)
+            {
+                link.m_prev = m_prev;
+                link.m_next = this;
+                m_prev->m_next = &link;
+                m_prev = &link;
+            }
+
+            /// Moves all links of this list to the empty list.
+            void MoveTo(Link& list)
+            {
+                if (IsLinked())
+                {
+                    list.m_prev = m_prev;
+                    list.m_next = m_next;
+                    m_prev->m_next = &list;
+                    m_next->m_prev = &list;
+                    m_prev = m_next = this;
+                }
+            }
+
+            Link* m_prev{ this };
+            Link* m_next{ this };
+        };
+
+        explicit Wheel(const std::chrono::milliseconds& tick)
+            : m_state{ std::make_shared<State>(tick) }
+        {}
+
+        ~Wheel()
+        {
+            {
+                std::lock_guard<std::mutex> guard{ m_state->m_lock };
+                m_state->m_stop = true;
+            }
+
+            m_state->m_tickCondition.notify_one();
+
+            if (m_thread.joinable())
+            {
+                if (m_thread.get_id() != std::this_thread::get_id())
+                {
+                    m_thread.join();
+                }
+                else
+                {
+                    m_thread.detach();  // Released from a handler, the thread exits after it returns.
+                }
+            }
+        }
+
+        /// Returns the wheel shared by all factories with the given tick.
+        static std::shared_ptr<Wheel> GetShared(const std::chrono::milliseconds& tick)
+        {
+            if (tick <= std::chrono::milliseconds::zero())
+            {
+                throw Exception{ "Timer wheel tick must be positive." };
+            }
+
+            static std::mutex s_lock;
+            static std::map<std::chrono::milliseconds::rep, std::weak_ptr<Wheel>> s_wheels;
+
+            std::lock_guard<std::mutex> guard{ s_lock };
+
+            auto& weakWheel = s_wheels[tick.count()];
+            auto wheel = weakWheel.lock();
+
+            if (!wheel)
+            {
+                wheel = std::make_shared<Wheel>(tick);
+                weakWheel = wheel;
+            }
+
+            return wheel;
+        }
+
+        void Schedule(Timer& timer, const std::chrono::milliseconds& timeout);
+
+        void Deactivate(Timer& timer);
+
+    private:
+        static constexpr std::size_t SlotBits = 6;
+        static constexpr std::size_t SlotCount = std::size_t{ 1 } << SlotBits;
+        static constexpr std::uint64_t SlotMask = SlotCount - 1;
+        static constexpr std::size_t LevelCount = 4;                            // Spans 2^24 ticks, longer timeouts are cascaded again.
+        static constexpr std::uint64_t MaxDelta = (std::uint64_t{ 1 } << (SlotBits * LevelCount)) - 1;
+
+        struct State
+        {
+            explicit State(const std::chrono::milliseconds& tick)
+                : m_tick{ tick },
+                  m_start{ std::chrono::steady_clock::now() }
+            {}
+
+            std::uint64_t Now() const
+            {
+                return static_cast<std::uint64_t>((std::chrono::steady_clock::now() - m_start) / m_tick);
+            }
+
+            const std::chrono::milliseconds m_tick;
+            const std::chrono::steady_clock::time_point m_start;
+            std::mutex m_lock;
+            std::condition_variable m_tickCondition;        // Wakes the wheel thread.
+            std::condition_variable m_handlerCondition;     // Signaled when a handler returns.
+            Link m_slots[LevelCount][SlotCount];
+            std::uint64_t m_current{ 0 };                   // The next tick to process.
+            std::size_t m_count{ 0 };                       // Scheduled timers.
+            const Timer* m_running{ nullptr };
+            std::thread::id m_threadId;
+            bool m_idle{ true };                            // The thread waits for the first timer, m_current may be moved.
+            bool m_stop{ false };
+        };
+
+
+        void Start()
+        {
+            std::thread thread{ [state = m_state] { Run(*state); } };
+
+            m_state->m_threadId = thread.get_id();
+            m_thread = std::move(thread);
+        }
+
+        /// Removes the timer from the wheel and waits for its running handler unless invoked from it.
+        void Unschedule(Timer& timer, std::unique_lock<std::mutex>& guard);
+
+        static void Run(State& state)
+        {
+            std::unique_lock<std::mutex> guard{ state.m_lock };
+
+            while (!state.m_stop)
+            {
+                if (state.m_count == 0)
+                {
+                    state.m_idle = true;
+                    state.m_tickCondition.wait(guard, [&] { return state.m_stop || state.m_count != 0; });
+                    state.m_idle = false;
+                }
+                else if (state.m_current <= state.Now())
+                {
+                    Advance(state, guard);
+                }
+                else
+                {
+                    state.m_tickCondition.wait_until(guard, state.m_start + state.m_tick * state.m_current);
+                }
+            }
+        }
+
+        /// Processes the current tick: cascades the higher levels which wrap and fires the expired timers.
+        static void Advance(State& state, std::unique_lock<std::mutex>& guard);
+
+        static void Insert(State& state, Timer& timer);
+
+
+        std::shared_ptr<State> m_state;     // Shared with the wheel thread so it may outlive this object.
+        std::thread m_thread;
+    };
+
+
+    class TimerWheelTimeoutFactory::Timer : public Wheel::Link, public std::enable_shared_from_this<Timer>
+    {
+    public:
+        template <typename Function>
+        Timer(std::shared_ptr<Wheel> wheel, Function&& func, const std::chrono::milliseconds& defaultTimeout)
+            : m_func{ std::forward<Function>(func) },
+              m_wheel{ std::move(wheel) },
+              m_defaultTimeout{ defaultTimeout }
+        {}
+
+        void Reset()
+        {
+            Reset(m_defaultTimeout);
+        }
+
+        void Reset(const std::chrono::milliseconds& timeout)
+        {
+            m_wheel->Schedule(*this, timeout);
+        }
+
+        void Deactivate()
+        {
+            m_wheel->Deactivate(*this);
+        }
+
+    private:
+        friend class Wheel;
+
+        detail::Callback<void()> m_func;
+        std::shared_ptr<Wheel> m_wheel;
+        std::chrono::milliseconds m_defaultTimeout;
+        std::uint64_t m_expiry{ 0 };    // Guarded by the wheel lock.
+    };
+
+
+    void TimerWheelTimeoutFactory::Wheel::Schedule(Timer& timer, const std::chrono::milliseconds& timeout)
+    {
+        auto& state = *m_state;
+        auto ticks = (std::max)(timeout.count() + state.m_tick.count() - 1, std::chrono::milliseconds::rep{ 0 }) / state.m_tick.count();
+
+        std::unique_lock<std::mutex> guard{ state.m_lock };
+
+        Unschedule(timer, guard);
+
+        if (!m_thread.joinable())
+        {
+            Start();
+        }
+
+        auto now = state.Now();
+
+        if (state.m_idle && state.m_count == 0)
+        {
+            state.m_current = now;      // Skips the ticks elapsed while the wheel was empty.
+        }
+
+        timer.m_expiry = now + static_cast<std::uint64_t>(ticks) + 1;   // The current tick is partially elapsed.
+
+        Insert(state, timer);
+        ++state.m_count;
+
+        if (state.m_idle)
+        {
+            state.m_tickCondition.notify_one();
+        }
+    }
+
+    void TimerWheelTimeoutFactory::Wheel::Deactivate(Timer& timer)
+    {
+        std::unique_lock<std::mutex> guard{ m_state->m_lock };
+
+        Unschedule(timer, guard);
+    }
+
+    void TimerWheelTimeoutFactory::Wheel::Unschedule(Timer& timer, std::unique_lock<std::mutex>& guard)
+    {
+        auto& state = *m_state;
+
+        while (true)
+        {
+            if (timer.IsLinked())
+            {
+                timer.Unlink();
+                --state.m_count;
+            }
+
+            if (state.m_running != &timer || state.m_threadId == std::this_thread::get_id())
+            {
+                break;
+            }
+
+            state.m_handlerCondition.wait(guard);   // The handler may schedule the timer again.
+        }
+    }
+
+    void TimerWheelTimeoutFactory::Wheel::Advance(State& state, std::unique_lock<std::mutex>& guard)
+    {
+        auto current = state.m_current;
+
+        for (std::size_t level = 1; level < LevelCount && ((current >> (SlotBits * (level - 1))) & SlotMask) == 0; ++level)
+        {
+            Link timers;
+            state.m_slots[level][(current >> (SlotBits * level)) & SlotMask].MoveTo(timers);
+
+            while (timers.IsLinked())
+            {
+                auto& timer = static_cast<Timer&>(*timers.m_next);
+                timer.Unlink();
+                Insert(state, timer);
+            }
+        }
+
+        Link expired;
+        state.m_slots[0][current & SlotMask].MoveTo(expired);
+
+        ++state.m_current;
+
+        // Timers scheduled or deactivated by handlers are moved out of the local list under the lock.
+        while (expired.IsLinked())
+        {
+            auto& timer = static_cast<Timer&>(*expired.m_next);
+            timer.Unlink();
+            --state.m_count;
+
+            auto keepAlive = timer.shared_from_this();  // Owners deactivate the timer before releasing it.
+            state.m_running = &timer;
+
+            guard.unlock();
+            timer.m_func();
+            guard.lock();
+
+            state.m_running = nullptr;
+            state.m_handlerCondition.notify_all();
+
+            guard.unlock();
+            keepAlive.reset();      // May release the wheel, which needs the lock.
+            guard.lock();
+        }
+    }
+
+    void TimerWheelTimeoutFactory::Wheel::Insert(State& state, Timer& timer)
+    {
+        auto expiry = (std::max)(timer.m_expiry, state.m_current);
+        auto delta = expiry - state.m_current;
+
+        std::size_t level = 0;
+
+        while (level + 1 < LevelCount && delta >= (std::uint64_t{ 1 } << (SlotBits * (level + 1))))
+        {
+            ++level;
+        }
+
+        expiry = state.m_current + (std::min)(delta, std::uint64_t{ MaxDelta });   // Beyond the top level, inserted again when cascaded.
+
+        state.m_slots[level][(expiry >> (SlotBits * level)) & SlotMask].PushBack(timer);
+    }
+
+
+    TimerWheelTimeoutFactory::Scheduler::Scheduler(std::shared_ptr<Timer> timer)
+        : m_timer{ std::move(timer) }
+    {}
+
+    TimerWheelTimeoutFactory::Scheduler::~Scheduler()
+    {
+        if (m_timer)
+        {
+            m_timer->Deactivate();
+        }
+    }
+
+    void TimerWheelTimeoutFactory::Scheduler::operator()() const
+    {
+        m_timer->Reset();
+    }
+
+    void TimerWheelTimeoutFactory::Scheduler::operator()(const std::chrono::milliseconds& timeout) const
+    {
+        m_timer->Reset(timeout);
+    }
+
+    void TimerWheelTimeoutFactory::Scheduler::operator()(std::nullptr_t) const
+    {
+        m_timer->Deactivate();
+    }
+
+
+    TimerWheelTimeoutFactory::TimerWheelTimeoutFactory(
+        const std::chrono::milliseconds& defaultTimeout, const std::chrono::milliseconds& tick, ReconnectPolicy reconnectPolicy)
+        : m_defaultTimeout{ defaultTimeout != std::chrono::milliseconds::zero() ? defaultTimeout : std::chrono::seconds{ 1 } },
+          m_wheel{ Wheel::GetShared(tick) },
+          m_reconnectPolicy{ std::move(reconnectPolicy) }
+    {}
+
+    auto TimerWheelTimeoutFactory::operator()(detail::Callback<void()> handler) const -> Scheduler
+    {
+        return Scheduler{ std::make_shared<Timer>(m_wheel, std::move(handler), m_defaultTimeout) };
+    }
+
+    auto TimerWheelTimeoutFactory::GetReconnectPolicy() const -> const ReconnectPolicy&
+    {
+        return m_reconnectPolicy;
+    }
+
+} // Policies
+} // IPC
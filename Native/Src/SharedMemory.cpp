@@ -1,11 +1,41 @@
 #include "stdafx.h"
 #include "IPC/SharedMemory.h"
 #include "IPC/Version.h"
+#include "IPC/detail/KernelObject.h"
+#include <psapi.h>
 #include <string>
+#include <array>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <algorithm>
+#include <iterator>
+#include <atomic>
+#include <thread>
+#include <cassert>
+
+#pragma warning(push)
+#include <boost/interprocess/windows_shared_memory.hpp>
+#include <boost/interprocess/detail/managed_open_or_create_impl.hpp>
+#pragma warning(pop)
+
+#pragma comment(lib, "psapi.lib")
 
 
 namespace IPC
 {
+    namespace detail
+    {
+        bool CommitMemory(void* address, std::size_t size)
+        {
+            // Pages of a reserved section committed through any view are visible in all of them.
+            return ::VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+        }
+
+    } // detail
+
+
     namespace
     {
         const char* MakeVersionedName(const char* name)
@@ -15,19 +45,444 @@ namespace IPC
             s_name += name;
             return s_name.c_str();
         }
+
+        /// Enables the privilege needed to create large page sections in the process token and
+        /// restores its previous state on destruction. Concurrent instances are serialized.
+        class LockMemoryPrivilege
+        {
+        public:
+            LockMemoryPrivilege()
+                : m_guard{ GetLock() }
+            {
+                HANDLE token;
+
+                if (!::OpenProcessToken(::GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token))
+                {
+                    return;
+                }
+
+                detail::KernelObject tokenObject{ token };
+
+                TOKEN_PRIVILEGES privileges{};
+                privileges.PrivilegeCount = 1;
+                privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+
+                DWORD size;
+
+                if (::LookupPrivilegeValue(nullptr, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid)
+                    && ::AdjustTokenPrivileges(token, FALSE, &privileges, sizeof(m_previous), &m_previous, &size)
+                    && ::GetLastError() == ERROR_SUCCESS)   // ERROR_NOT_ALL_ASSIGNED if the account does not hold the privilege.
+                {
+                    m_token = std::move(tokenObject);
+                }
+            }
+
+            LockMemoryPrivilege(const LockMemoryPrivilege& other) = delete;
+            LockMemoryPrivilege& operator=(const LockMemoryPrivilege& other) = delete;
+
+            ~LockMemoryPrivilege()
+            {
+                if (m_token && m_previous.PrivilegeCount != 0)  // Nothing is reported when it was already enabled.
+                {
+                    ::AdjustTokenPrivileges(static_cast<void*>(m_token), FALSE, &m_previous, 0, nullptr, nullptr);
+                }
+            }
+
+            explicit operator bool() const
+            {
+                return static_cast<bool>(m_token);
+            }
+
+        private:
+            static std::mutex& GetLock()
+            {
+                static std::mutex s_lock;
+                return s_lock;
+            }
+
+            std::lock_guard<std::mutex> m_guard;
+            detail::KernelObject m_token{ nullptr };
+            TOKEN_PRIVILEGES m_previous{};
+        };
+
+        template <typename Function>
+        auto Measure(std::chrono::microseconds& duration, Function&& func)
+        {
+            auto start = std::chrono::steady_clock::now();
+            auto result = func();
+            duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+            return result;
+        }
+
+        /// Grows the working set by size bytes and returns a handle shrinking it back.
+        std::shared_ptr<void> ReserveWorkingSet(std::size_t size)
+        {
+            static std::mutex s_lock;
+            std::lock_guard<std::mutex> guard{ s_lock };
+
+            SIZE_T minSize, maxSize;
+
+            if (!::GetProcessWorkingSetSize(::GetCurrentProcess(), &minSize, &maxSize)
+                || !::SetProcessWorkingSetSize(::GetCurrentProcess(), minSize + size, maxSize + size))
+            {
+                return{};
+            }
+
+            return{ (void*)true, [size](void*)
+            {
+                std::lock_guard<std::mutex> guard{ s_lock };
+
+                SIZE_T minSize, maxSize;
+
+                if (::GetProcessWorkingSetSize(::GetCurrentProcess(), &minSize, &maxSize))
+                {
+                    ::SetProcessWorkingSetSize(::GetCurrentProcess(), minSize - size, maxSize - size);
+                }
+            } };
+        }
+
+        bool IsLargePageMapping(void* address)
+        {
+            PSAPI_WORKING_SET_EX_INFORMATION info{};
+            info.VirtualAddress = address;
+
+            return ::QueryWorkingSetEx(::GetCurrentProcess(), &info, sizeof(info))
+                && info.VirtualAttributes.Valid
+                && info.VirtualAttributes.LargePage;
+        }
     }
 
 
+    /// Keeps small free blocks of one memory for one thread. Half of a full magazine is returned
+    /// to the shared size class lists and an empty one is refilled with a batch from them.
+    /// Only the owning thread touches the magazines until the memory or the thread goes away,
+    /// so as with any other allocation the memory must not be used while it is being released.
+    class SharedMemory::ThreadCache
+    {
+    public:
+        explicit ThreadCache(MemoryAlgorithm& algorithm)
+            : m_algorithm{ &algorithm }
+        {
+            for (std::size_t i = 0; i != m_magazines.size(); ++i)
+            {
+                m_magazines[i].m_capacity = (std::max)(c_minBlocks,
+                    (std::min)(c_maxBlocks, static_cast<std::size_t>(c_maxBytes / MemoryAlgorithm::GetClassSize(i))));
+            }
+        }
+
+        ThreadCache(const ThreadCache& other) = delete;
+        ThreadCache& operator=(const ThreadCache& other) = delete;
+
+        /// Returns the cache of the calling thread for the given memory
+        /// or null if the thread is exiting and its caches are gone.
+        static ThreadCache* Get(MemoryAlgorithm& algorithm)
+        {
+            auto& last = GetLast();
+
+            if (last && last->IsAttachedTo(algorithm))
+            {
+                return last;
+            }
+
+            return last = Find(algorithm);
+        }
+
+        /// Returns the blocks cached by all threads for the given memory.
+        static void ReleaseAll(MemoryAlgorithm& algorithm)
+        {
+            for (auto& cache : GetRegistry().Extract(algorithm))
+            {
+                cache->Release();
+            }
+        }
+
+        void* Allocate(std::size_t index)
+        {
+            auto& magazine = m_magazines[index];
+
+            if (magazine.m_count == 0 && !Refill(index))
+            {
+                return nullptr;
+            }
+
+            return magazine.m_blocks[--magazine.m_count];
+        }
+
+        void Deallocate(std::size_t index, void* ptr)
+        {
+            auto& magazine = m_magazines[index];
+
+            if (magazine.m_count == magazine.m_capacity)
+            {
+                magazine.m_count -= magazine.m_capacity / 2;
+                GetAlgorithm().PushBatch(index, &magazine.m_blocks[magazine.m_count], magazine.m_capacity / 2);
+            }
+
+            magazine.m_blocks[magazine.m_count++] = ptr;
+        }
+
+        /// Returns all blocks and detaches from the memory. Returns the memory it was attached to.
+        MemoryAlgorithm* Release()
+        {
+            std::lock_guard<std::mutex> guard{ m_releaseLock };
+
+            auto algorithm = m_algorithm.load(std::memory_order_relaxed);
+
+            if (algorithm)
+            {
+                Flush();
+                m_algorithm.store(nullptr, std::memory_order_release);
+            }
+
+            return algorithm;
+        }
+
+    private:
+        static constexpr std::size_t c_minBlocks = 4;
+        static constexpr std::size_t c_maxBlocks = 32;
+        static constexpr std::size_t c_maxBytes = 16 * 1024;    // Bounds the memory a thread holds per class.
+
+        struct Magazine
+        {
+            std::size_t m_count{ 0 };
+            std::size_t m_capacity{ 0 };
+            std::array<void*, c_maxBlocks> m_blocks;
+        };
+
+        class Registry
+        {
+        public:
+            void Add(const MemoryAlgorithm& algorithm, std::shared_ptr<ThreadCache> cache)
+            {
+                std::lock_guard<std::mutex> guard{ m_lock };
+                m_caches[&algorithm].push_back(std::move(cache));
+            }
+
+            void Remove(const MemoryAlgorithm& algorithm, const ThreadCache& cache)
+            {
+                std::lock_guard<std::mutex> guard{ m_lock };
+
+                auto it = m_caches.find(&algorithm);
+
+                if (it != m_caches.end())
+                {
+                    auto& caches = it->second;
+                    caches.erase(
+                        std::remove_if(caches.begin(), caches.end(), [&](const auto& other) { return other.get() == &cache; }),
+                        caches.end());
+
+                    if (caches.empty())
+                    {
+                        m_caches.erase(it);
+                    }
+                }
+            }
+
+            std::vector<std::shared_ptr<ThreadCache>> Extract(const MemoryAlgorithm& algorithm)
+            {
+                std::vector<std::shared_ptr<ThreadCache>> caches;
+
+                std::lock_guard<std::mutex> guard{ m_lock };
+
+                auto it = m_caches.find(&algorithm);
+
+                if (it != m_caches.end())
+                {
+                    caches = std::move(it->second);
+                    m_caches.erase(it);
+                }
+
+                return caches;
+            }
+
+        private:
+            std::mutex m_lock;
+            std::unordered_map<const MemoryAlgorithm*, std::vector<std::shared_ptr<ThreadCache>>> m_caches;
+        };
+
+        /// Caches of a single thread, flushed when the thread exits.
+        class Caches
+        {
+        public:
+            Caches() = default;
+
+            Caches(const Caches& other) = delete;
+            Caches& operator=(const Caches& other) = delete;
+
+            ~Caches()
+            {
+                GetLast() = nullptr;
+                IsExited() = true;
+
+                for (auto& cache : m_caches)
+                {
+                    if (auto algorithm = cache->Release())
+                    {
+                        GetRegistry().Remove(*algorithm, *cache);
+                    }
+                }
+            }
+
+            ThreadCache& Find(MemoryAlgorithm& algorithm)
+            {
+                // Drop the caches of released memory, one of them may have had the same address.
+                m_caches.erase(
+                    std::remove_if(m_caches.begin(), m_caches.end(), [](const auto& cache) { return cache->IsDetached(); }),
+                    m_caches.end());
+
+                auto it = std::find_if(
+                    m_caches.begin(), m_caches.end(), [&](const auto& cache) { return cache->IsAttachedTo(algorithm); });
+
+                if (it == m_caches.end())
+                {
+                    auto cache = std::make_shared<ThreadCache>(algorithm);
+                    GetRegistry().Add(algorithm, cache);
+                    m_caches.push_back(std::move(cache));
+                    it = std::prev(m_caches.end());
+                }
+
+                return **it;
+            }
+
+        private:
+            std::vector<std::shared_ptr<ThreadCache>> m_caches;
+        };
+
+
+        static Registry& GetRegistry()
+        {
+            static Registry s_registry;
+            return s_registry;
+        }
+
+        static ThreadCache*& GetLast()
+        {
+            thread_local ThreadCache* t_last{ nullptr };    // Trivial, so the hot path needs no initialization check.
+            return t_last;
+        }
+
+        static bool& IsExited()
+        {
+            thread_local bool t_exited{ false };
+            return t_exited;
+        }
+
+        static ThreadCache* Find(MemoryAlgorithm& algorithm)
+        {
+            if (IsExited())
+            {
+                return nullptr;
+            }
+
+            thread_local Caches t_caches;
+            return &t_caches.Find(algorithm);
+        }
+
+        bool IsAttachedTo(const MemoryAlgorithm& algorithm) const
+        {
+            return m_algorithm.load(std::memory_order_acquire) == &algorithm;
+        }
+
+        bool IsDetached() const
+        {
+            return m_algorithm.load(std::memory_order_acquire) == nullptr;
+        }
+
+        MemoryAlgorithm& GetAlgorithm()
+        {
+            auto algorithm = m_algorithm.load(std::memory_order_relaxed);
+            assert(algorithm);
+            return *algorithm;
+        }
+
+        bool Refill(std::size_t index)
+        {
+            auto& magazine = m_magazines[index];
+
+            magazine.m_count = GetAlgorithm().PopBatch(index, magazine.m_blocks.data(), magazine.m_capacity / 2);
+
+            if (magazine.m_count == 0)
+            {
+                Flush();    // Out of memory, give the other classes a chance to be merged.
+                magazine.m_count = GetAlgorithm().PopBatch(index, magazine.m_blocks.data(), 1);
+            }
+
+            return magazine.m_count != 0;
+        }
+
+        void Flush()
+        {
+            for (std::size_t i = 0; i != m_magazines.size(); ++i)
+            {
+                auto& magazine = m_magazines[i];
+
+                GetAlgorithm().PushBatch(i, magazine.m_blocks.data(), magazine.m_count);
+                magazine.m_count = 0;
+            }
+        }
+
+
+        std::atomic<MemoryAlgorithm*> m_algorithm;
+        std::mutex m_releaseLock;       // Serializes the thread exit with the memory release.
+        std::array<Magazine, MemoryAlgorithm::c_classCount> m_magazines;
+    };
+
+
     SharedMemory::SharedMemory(create_only_t, const char* name, std::size_t size)
-        : m_memory{ create_only, MakeVersionedName(name), size },
-          m_name{ name }
+        : SharedMemory{ create_only, name, size, {} }
     {}
 
+    SharedMemory::SharedMemory(create_only_t, const char* name, std::size_t size, const Options& options)
+        : m_mapping{ Measure(m_timings.m_map, [&] { return CreateMapping(name ? MakeVersionedName(name) : nullptr, size, options); }) },
+          m_memory{ OpenMemory(m_mapping) },
+          m_name{ name ? name : "" },
+          m_largePages{ options.m_largePages && IsLargePageMapping(m_memory.get_address()) }
+    {
+        if (options.m_prefault || options.m_lockPages)
+        {
+            Prefault(options.m_lockPages);
+        }
+    }
+
     SharedMemory::SharedMemory(open_only_t, const char* name)
-        : m_memory{ open_only, MakeVersionedName(name) },
-          m_name{ name }
+        : m_mapping{ Measure(m_timings.m_map, [&] { return OpenMapping(MakeVersionedName(name)); }) },
+          m_memory{ OpenMemory(m_mapping) },
+          m_name{ name },
+          m_largePages{ IsLargePageMapping(m_memory.get_address()) }
     {}
 
+    SharedMemory::SharedMemory(open_only_t, std::uint64_t section)
+        : m_mapping{ Measure(m_timings.m_map, [&]
+            {
+                return OpenSectionMapping(detail::KernelObject{ reinterpret_cast<void*>(static_cast<std::uintptr_t>(section)) });
+            }) },
+          m_memory{ OpenMemory(m_mapping) },
+          m_largePages{ IsLargePageMapping(m_memory.get_address()) }
+    {}
+
+    SharedMemory& SharedMemory::operator=(SharedMemory&& other)
+    {
+        if (this != &other)
+        {
+            ReleaseThreadCaches();
+            m_memory = std::move(other.m_memory);
+            m_mapping = std::move(other.m_mapping);
+            m_name = std::move(other.m_name);
+            m_largePages = other.m_largePages;
+            m_pageLock = std::move(other.m_pageLock);
+            m_prefaultedSize = other.m_prefaultedSize;
+            m_prefaultLock = std::move(other.m_prefaultLock);
+            m_timings = other.m_timings;
+        }
+
+        return *this;
+    }
+
+    SharedMemory::~SharedMemory()
+    {
+        ReleaseThreadCaches();
+    }
+
     bool SharedMemory::Contains(const void* ptr) const
     {
         return m_memory.belongs_to_segment(ptr);
@@ -38,6 +493,111 @@ namespace IPC
         return m_memory.get_free_memory();
     }
 
+    std::size_t SharedMemory::GetSize() const
+    {
+        return m_memory.get_segment_manager()->get_size();
+    }
+
+    std::size_t SharedMemory::GetMaxSize() const
+    {
+        return GetMemoryAlgorithm(*m_memory.get_segment_manager()).GetMaxSize();
+    }
+
+    bool SharedMemory::HasLargePages() const
+    {
+        return m_largePages;
+    }
+
+    bool SharedMemory::Prefault(bool lockPages)
+    {
+        // Only the committed part of a growable memory can be touched.
+        auto address = reinterpret_cast<char*>(m_memory.get_segment_manager());
+        auto size = GetSize();
+
+        std::lock_guard<std::mutex> guard{ *m_prefaultLock };
+
+        if (m_prefaultedSize < size)
+        {
+            Measure(m_timings.m_prefault, [&]
+            {
+                SYSTEM_INFO info;
+                ::GetSystemInfo(&info);
+
+                auto offset = m_prefaultedSize;
+
+                for (; offset < size; offset += info.dwPageSize)
+                {
+                    // Adding zero faults the page in for writing without changing what other threads see.
+                    ::InterlockedExchangeAdd(reinterpret_cast<volatile LONG*>(address + offset), 0);
+                }
+
+                m_prefaultedSize = offset;
+
+                return true;
+            });
+        }
+
+        if (lockPages && !IsLocked())
+        {
+            Measure(m_timings.m_lock, [&]
+            {
+                auto pageLock = ReserveWorkingSet(size);
+
+                if (pageLock && ::VirtualLock(address, size))
+                {
+                    m_pageLock = std::move(pageLock);
+                }
+
+                return true;
+            });
+        }
+
+        return !lockPages || IsLocked();
+    }
+
+    bool SharedMemory::IsLocked() const
+    {
+        return m_largePages || m_pageLock;    // Large pages are never paged out.
+    }
+
+    auto SharedMemory::GetTimings() const -> const Timings&
+    {
+        return m_timings;
+    }
+
+    auto SharedMemory::GetStatistics() const -> Statistics
+    {
+        auto& algorithm = GetMemoryAlgorithm(*m_memory.get_segment_manager());
+
+        Statistics statistics;
+        statistics.m_size = GetSize();
+
+        algorithm.ForEachFreeBlock(
+            [&](std::size_t size)
+            {
+                statistics.m_freeSize += size;
+                statistics.m_largestFreeBlock = (std::max)(statistics.m_largestFreeBlock, size);
+
+                std::size_t index = 0;
+
+                for (size >>= 7; size != 0 && index + 1 < statistics.m_freeBlocks.size(); size >>= 1)
+                {
+                    ++index;
+                }
+
+                ++statistics.m_freeBlocks[index];
+            });
+
+        // The lists are read after the walk, so blocks moving in between may be counted twice.
+        statistics.m_cachedSize = (std::min)(algorithm.GetCachedSize(), statistics.m_size - statistics.m_freeSize);
+        statistics.m_usedSize = statistics.m_size - statistics.m_freeSize - statistics.m_cachedSize;
+        statistics.m_highWaterMark = (std::max)(algorithm.GetHighWaterMark(), statistics.m_usedSize + statistics.m_cachedSize);
+        statistics.m_namedObjects = m_memory.get_segment_manager()->get_num_named_objects();
+        statistics.m_uniqueObjects = m_memory.get_segment_manager()->get_num_unique_objects();
+
+        return statistics;
+    }
+
     std::size_t SharedMemory::GetMinSize()
     {
         return ManagedSharedMemory::segment_manager::get_min_size();
@@ -48,4 +608,264 @@ namespace IPC
         return m_name;
     }
 
+    std::uint64_t SharedMemory::Share(std::uint32_t processId) const
+    {
+        detail::KernelObject process{ ::OpenProcess(PROCESS_DUP_HANDLE, FALSE, processId) };
+        HANDLE handle;
+
+        if (!process
+            || !::DuplicateHandle(
+                ::GetCurrentProcess(),
+                static_cast<void*>(m_mapping.m_section),
+                static_cast<void*>(process),
+                &handle,
+                0,
+                FALSE,
+                DUPLICATE_SAME_ACCESS))
+        {
+            throw Exception{ "Failed to share the memory." };
+        }
+
+        return reinterpret_cast<std::uintptr_t>(handle);
+    }
+
+    void SharedMemory::Unshare(std::uint64_t section, std::uint32_t processId) noexcept
+    {
+        if (section != 0)
+        {
+            if (auto process = ::OpenProcess(PROCESS_DUP_HANDLE, FALSE, processId))
+            {
+                ::DuplicateHandle(
+                    process,
+                    reinterpret_cast<HANDLE>(static_cast<std::uintptr_t>(section)),
+                    nullptr,
+                    nullptr,
+                    0,
+                    FALSE,
+                    DUPLICATE_CLOSE_SOURCE);
+
+                ::CloseHandle(process);
+            }
+        }
+    }
+
+    auto SharedMemory::CreateMapping(const char* name, std::size_t size, const Options& options) -> Mapping
+    {
+        if (options.m_largePages)
+        {
+            try
+            {
+                return CreateLargePageMapping(name, size, options);
+            }
+            catch (const std::exception&)
+            {}  // Fall back to regular pages.
+        }
+
+        if (options.m_maxSize > size)
+        {
+            return CreateGrowableMapping(name, size, options.m_maxSize, options);
+        }
+
+        return CreateSectionMapping(name, size, size, SEC_COMMIT, options);
+    }
+
+    auto SharedMemory::CreateLargePageMapping(const char* name, std::size_t size, const Options& options) -> Mapping
+    {
+        auto pageSize = ::GetLargePageMinimum();
+        LockMemoryPrivilege privilege;      // Only needed while the section is created.
+
+        if (pageSize == 0 || !privilege)
+        {
+            throw Exception{ "Large pages are not available." };
+        }
+
+        size = (size + pageSize - 1) / pageSize * pageSize;
+
+        return CreateSectionMapping(name, size, size, SEC_COMMIT | SEC_LARGE_PAGES, options);
+    }
+
+    auto SharedMemory::CreateGrowableMapping(const char* name, std::size_t size, std::size_t maxSize, const Options& options) -> Mapping
+    {
+        SYSTEM_INFO info;
+        ::GetSystemInfo(&info);
+
+        auto pageSize = static_cast<std::size_t>(info.dwPageSize);
+
+        size = (size + pageSize - 1) / pageSize * pageSize;
+        maxSize = (maxSize + pageSize - 1) / pageSize * pageSize;
+
+        return CreateSectionMapping(name, size, maxSize, SEC_RESERVE, options);
+    }
+
+    auto SharedMemory::CreateSectionMapping(const char* name, std::size_t size, std::size_t maxSize, std::uint32_t flags, const Options& options) -> Mapping
+    {
+        assert(size <= maxSize);
+
+        // The section is initialized the same way managed_windows_shared_memory does it, so
+        // that it can be opened by any version. The view covers the whole section, including
+        // pages committed later.
+        auto handle = ::CreateFileMappingA(
+            INVALID_HANDLE_VALUE,
+            nullptr,
+            PAGE_READWRITE | flags,
+            static_cast<DWORD>(static_cast<std::uint64_t>(maxSize) >> 32),
+            static_cast<DWORD>(maxSize),
+            name);
+
+        if (!handle)
+        {
+            throw Exception{ "Failed to create a section." };
+        }
+
+        detail::KernelObject section{ handle };
+
+        if (name && ::GetLastError() == ERROR_ALREADY_EXISTS)
+        {
+            throw Exception{ "Shared memory already exists." };
+        }
+
+        std::shared_ptr<void> view{ ::MapViewOfFile(handle, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, maxSize), ::UnmapViewOfFile };
+
+        if (!view.get())
+        {
+            throw Exception{ "Failed to map a section." };
+        }
+
+        if ((flags & SEC_RESERVE) && !detail::CommitMemory(view.get(), size))
+        {
+            throw Exception{ "Failed to commit memory." };
+        }
+
+        constexpr std::uint32_t c_initializedSegment = 2;     // InitializedSegment of managed_open_or_create_impl, which is private.
+
+        auto offset = GetHeaderSize();
+
+        ManagedSharedMemory memory{ create_only, static_cast<char*>(view.get()) + offset, size - offset };
+        auto& algorithm = GetMemoryAlgorithm(*memory.get_segment_manager());
+
+        if (size != maxSize)
+        {
+            algorithm.EnableGrowth(maxSize - offset);
+        }
+
+        if (options.m_hashedIndex)
+        {
+            assert(memory.get_num_named_objects() == 0 && memory.get_num_unique_objects() == 0);
+            algorithm.EnableHashedIndex();
+        }
+
+        if (options.m_threadCaches)
+        {
+            algorithm.EnableThreadCaching();
+        }
+        else if (options.m_sizeClasses)
+        {
+            algorithm.EnableSizeClasses();
+        }
+
+        static_cast<std::atomic<std::uint32_t>*>(view.get())->store(c_initializedSegment, std::memory_order_release);
+
+        return{ std::move(section), std::move(view) };
+    }
+
+    auto SharedMemory::OpenMapping(const char* name) -> Mapping
+    {
+        auto handle = ::OpenFileMappingA(FILE_MAP_READ | FILE_MAP_WRITE, FALSE, name);
+
+        if (!handle)
+        {
+            throw Exception{ "Failed to open a section." };
+        }
+
+        return OpenSectionMapping(detail::KernelObject{ handle });
+    }
+
+    auto SharedMemory::OpenSectionMapping(detail::KernelObject section) -> Mapping
+    {
+        std::shared_ptr<void> view{
+            ::MapViewOfFile(static_cast<void*>(section), FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, 0), ::UnmapViewOfFile };
+
+        if (!view.get())
+        {
+            throw Exception{ "Failed to map a section." };
+        }
+
+        constexpr std::uint32_t c_uninitializedSegment = 0;
+        constexpr std::uint32_t c_initializingSegment = 1;
+        constexpr std::uint32_t c_initializedSegment = 2;
+
+        auto& state = *static_cast<std::atomic<std::uint32_t>*>(view.get());
+        std::uint32_t value;
+
+        // A named section is visible before the creator has initialized it.
+        while ((value = state.load(std::memory_order_acquire)) == c_uninitializedSegment || value == c_initializingSegment)
+        {
+            std::this_thread::yield();
+        }
+
+        if (value != c_initializedSegment)
+        {
+            throw Exception{ "Shared memory is corrupted." };
+        }
+
+        return{ std::move(section), std::move(view) };
+    }
+
+    auto SharedMemory::OpenMemory(const Mapping& mapping) -> ManagedSharedMemory
+    {
+        auto address = static_cast<char*>(mapping.m_view.get()) + GetHeaderSize();
+
+        // The size is not used when opening, the segment manager keeps its own.
+        return{ open_only, address, reinterpret_cast<ManagedSharedMemory::segment_manager*>(address)->get_size() };
+    }
+
+    std::size_t SharedMemory::GetHeaderSize()
+    {
+        return detail::ipc::ipcdetail::managed_open_or_create_impl<
+            detail::ipc::windows_shared_memory, MemoryAlgorithm::Alignment, false, false>::ManagedOpenOrCreateUserOffset;
+    }
+
+    void* SharedMemory::AllocateCached(MemoryAlgorithm& algorithm, std::size_t size)
+    {
+        if (auto cache = ThreadCache::Get(algorithm))
+        {
+            return cache->Allocate(MemoryAlgorithm::GetAllocationClass(size));
+        }
+
+        return algorithm.allocate(size);
+    }
+
+    bool SharedMemory::DeallocateCached(MemoryAlgorithm& algorithm, void* ptr)
+    {
+        auto index = algorithm.GetBlockClass(ptr);
+
+        if (index == MemoryAlgorithm::c_classCount)
+        {
+            return false;
+        }
+
+        auto cache = ThreadCache::Get(algorithm);
+
+        if (!cache)
+        {
+            return false;
+        }
+
+        cache->Deallocate(index, ptr);
+        return true;
+    }
+
+    void SharedMemory::ReleaseThreadCaches()
+    {
+        if (auto manager = m_memory.get_segment_manager())
+        {
+            auto& algorithm = GetMemoryAlgorithm(*manager);
+
+            if (algorithm.IsThreadCachingEnabled())
+            {
+                ThreadCache::ReleaseAll(algorithm);
+            }
+        }
+    }
+
 } // IPC
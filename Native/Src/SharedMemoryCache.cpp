@@ -3,7 +3,12 @@
 #include "IPC/SharedMemory.h"
 #include <unordered_map>
 #include <string>
+#include <vector>
+#include <list>
+#include <algorithm>
+#include <mutex>
 #include <shared_mutex>
+#include <atomic>
 
 
 namespace IPC
@@ -11,13 +16,27 @@ namespace IPC
     class SharedMemoryCache::Impl
     {
     public:
-        std::shared_ptr<SharedMemory> Create(const char* name, std::size_t size)
+        explicit Impl(const Options& options)
+            : m_options{ options }
+        {}
+
+        std::shared_ptr<SharedMemory> Create(const char* name, std::size_t size, const SharedMemory::Options& options)
         {
-            auto memory = std::make_shared<SharedMemory>(create_only, name, size);
+            std::vector<std::shared_ptr<SharedMemory>> released;   // Unmapped after the locks are released.
+            Expire(released);
+
+            auto memory = std::make_shared<SharedMemory>(create_only, name, size, options);
 
             {
                 std::lock_guard<decltype(m_lock)> guard{ m_lock };
-                m_cache[name] = memory;
+
+                auto result = m_cache.emplace(name, Entry{ memory, m_kept.end() });
+                if (!result.second)
+                {
+                    result.first->second.m_memory = memory;
+                }
+
+                Cleanup();
             }
 
             return memory;
@@ -25,18 +44,25 @@ namespace IPC
 
         std::shared_ptr<SharedMemory> Open(const char* name)
         {
-            if (auto memory = TryOpen(name))
+            std::vector<std::shared_ptr<SharedMemory>> released;   // Unmapped after the locks are released.
+
+            if (auto memory = TryOpen(name, released))
             {
+                ++m_hitCount;
                 return memory;
             }
 
             std::lock_guard<decltype(m_lock)> guard{ m_lock };
 
-            auto result = m_cache.emplace(name, std::weak_ptr<SharedMemory>{});
+            auto result = m_cache.emplace(name, Entry{ {}, m_kept.end() });
+            auto& entry = result.first->second;
+
             if (!result.second)
             {
-                if (auto memory = result.first->second.lock())
+                if (auto memory = entry.m_memory.lock())
                 {
+                    ++m_hitCount;
+                    Keep(entry, memory, released);
                     return memory;
                 }
             }
@@ -45,7 +71,7 @@ namespace IPC
 
             try
             {
-                result.first->second = memory = std::make_shared<SharedMemory>(open_only, name);
+                entry.m_memory = memory = std::make_shared<SharedMemory>(open_only, name);
             }
             catch (...)
             {
@@ -53,21 +79,117 @@ namespace IPC
                 throw;
             }
 
+            ++m_missCount;
+            Keep(entry, memory, released);
             Cleanup();
 
             return memory;
         }
 
+        Statistics GetStatistics()
+        {
+            {
+                std::vector<std::shared_ptr<SharedMemory>> released;
+                Expire(released);
+            }
+
+            std::vector<std::shared_ptr<SharedMemory>> memories;
+            {
+                std::shared_lock<decltype(m_lock)> guard{ m_lock };
+                memories.reserve(m_cache.size());
+
+                for (auto& entry : m_cache)
+                {
+                    if (auto memory = entry.second.m_memory.lock())
+                    {
+                        memories.push_back(std::move(memory));
+                    }
+                }
+            }
+
+            Statistics statistics;
+            auto& total = statistics.m_total;
+
+            for (auto& memory : memories)
+            {
+                auto current = memory->GetStatistics();
+
+                total.m_size += current.m_size;
+                total.m_usedSize += current.m_usedSize;
+                total.m_cachedSize += current.m_cachedSize;
+                total.m_freeSize += current.m_freeSize;
+                total.m_largestFreeBlock = (std::max)(total.m_largestFreeBlock, current.m_largestFreeBlock);
+                total.m_highWaterMark += current.m_highWaterMark;
+                total.m_namedObjects += current.m_namedObjects;
+                total.m_uniqueObjects += current.m_uniqueObjects;
+
+                for (std::size_t i = 0; i < total.m_freeBlocks.size(); ++i)
+                {
+                    total.m_freeBlocks[i] += current.m_freeBlocks[i];
+                }
+            }
+
+            statistics.m_memoryCount = memories.size();
+            statistics.m_hitCount = m_hitCount;
+            statistics.m_missCount = m_missCount;
+
+            {
+                std::lock_guard<std::mutex> guard{ m_keptLock };
+                statistics.m_keptCount = m_kept.size();
+            }
+
+            return statistics;
+        }
+
+        void Clear()
+        {
+            std::vector<std::shared_ptr<SharedMemory>> released;
+
+            std::shared_lock<decltype(m_lock)> guard{ m_lock };
+            std::lock_guard<std::mutex> keptGuard{ m_keptLock };
+
+            for (auto& kept : m_kept)
+            {
+                kept.m_entry->m_kept = m_kept.end();
+                released.push_back(std::move(kept.m_memory));
+            }
+
+            m_kept.clear();
+        }
+
     private:
-        std::shared_ptr<SharedMemory> TryOpen(const char* name)
+        using Clock = std::chrono::steady_clock;
+
+        struct Entry;
+
+        struct Kept
+        {
+            std::shared_ptr<SharedMemory> m_memory;
+            Entry* m_entry;
+            Clock::time_point m_lastOpen;
+        };
+
+        using KeptList = std::list<Kept>;    // Most recently opened first.
+
+        struct Entry
+        {
+            std::weak_ptr<SharedMemory> m_memory;
+            KeptList::iterator m_kept;          // End if not kept. Guarded by m_keptLock.
+        };
+
+        static constexpr std::size_t c_cleanupBuckets = 2;
+
+
+        std::shared_ptr<SharedMemory> TryOpen(const char* name, std::vector<std::shared_ptr<SharedMemory>>& released)
         {
             std::shared_lock<decltype(m_lock)> guard{ m_lock };
 
             auto it = m_cache.find(name);
             if (it != m_cache.end())
             {
-                if (auto memory = it->second.lock())
+                if (auto memory = it->second.m_memory.lock())
                 {
+                    Keep(it->second, memory, released);
                     return memory;
                 }
             }
@@ -75,35 +197,114 @@ namespace IPC
             return{};
         }
 
+        /// Moves the memory to the front of the kept ones and releases the ones over the
+        /// capacity or expired. The entries stay in the map since the memory is alive.
+        void Keep(Entry& entry, const std::shared_ptr<SharedMemory>& memory, std::vector<std::shared_ptr<SharedMemory>>& released)
+        {
+            if (m_options.m_capacity == 0)
+            {
+                return;
+            }
+
+            auto now = Clock::now();
+
+            std::lock_guard<std::mutex> guard{ m_keptLock };
+
+            if (entry.m_kept != m_kept.end())
+            {
+                m_kept.splice(m_kept.begin(), m_kept, entry.m_kept);
+                entry.m_kept->m_lastOpen = now;
+            }
+            else
+            {
+                m_kept.push_front(Kept{ memory, &entry, now });
+                entry.m_kept = m_kept.begin();
+            }
+
+            Release(now, released);
+        }
+
+        /// Releases the kept memories not opened within the TTL.
+        void Expire(std::vector<std::shared_ptr<SharedMemory>>& released)
+        {
+            if (m_options.m_ttl.count() == 0)
+            {
+                return;
+            }
+
+            auto now = Clock::now();
+
+            std::lock_guard<std::mutex> guard{ m_keptLock };
+
+            Release(now, released);
+        }
+
+        /// Releases the least recently opened memories over the capacity or expired.
+        /// Must be called under m_keptLock.
+        void Release(Clock::time_point now, std::vector<std::shared_ptr<SharedMemory>>& released)
+        {
+            while (!m_kept.empty()
+                && (m_kept.size() > m_options.m_capacity
+                    || (m_options.m_ttl.count() != 0 && now - m_kept.back().m_lastOpen >= m_options.m_ttl)))
+            {
+                auto& kept = m_kept.back();
+                kept.m_entry->m_kept = m_kept.end();
+                released.push_back(std::move(kept.m_memory));
+                m_kept.pop_back();
+            }
+        }
+
+        /// Drops the released entries of a few buckets per call, so that no single
+        /// call walks the whole map while the dead entries are still bounded.
         void Cleanup()
         {
-            for (auto it = m_cache.begin(); it != m_cache.end(); )
+            for (std::size_t i = 0; i != c_cleanupBuckets; ++i)
             {
-                if (it->second.expired())
-                {
-                    it = m_cache.erase(it);
-                }
-                else
+                auto bucket = m_cleanupBucket++ % m_cache.bucket_count();
+
+                for (auto it = m_cache.begin(bucket); it != m_cache.end(bucket); ++it)
                 {
-                    ++it;
+                    if (it->second.m_memory.expired())
+                    {
+                        m_expired.push_back(it->first);
+                    }
                 }
             }
+
+            for (const auto& name : m_expired)
+            {
+                m_cache.erase(name);
+            }
+
+            m_expired.clear();
         }
 
-        std::unordered_map<std::string, std::weak_ptr<SharedMemory>> m_cache;
-        std::shared_timed_mutex m_lock; // TODO: Use std::shared_mutex when available in VC14.
+
+        const Options m_options;
+        std::unordered_map<std::string, Entry> m_cache;
+        std::vector<std::string> m_expired;
+        std::size_t m_cleanupBucket{ 0 };
+        KeptList m_kept;
+        mutable std::mutex m_keptLock;
+        std::atomic<std::uint64_t> m_hitCount{ 0 };
+        std::atomic<std::uint64_t> m_missCount{ 0 };
+        mutable std::shared_timed_mutex m_lock; // TODO: Use std::shared_mutex when available in VC14.
     };
 
 
     SharedMemoryCache::SharedMemoryCache()
-        : m_impl{ std::make_unique<Impl>() }
+        : SharedMemoryCache{ Options{} }
+    {}
+
+    SharedMemoryCache::SharedMemoryCache(const Options& options)
+        : m_impl{ std::make_unique<Impl>(options) }
     {}
 
     SharedMemoryCache::~SharedMemoryCache() = default;
 
-    std::shared_ptr<SharedMemory> SharedMemoryCache::Create(const char* name, std::size_t size)
+    std::shared_ptr<SharedMemory> SharedMemoryCache::Create(const char* name, std::size_t size, const SharedMemory::Options& options)
     {
-        return m_impl->Create(name, size);
+        return m_impl->Create(name, size, options);
     }
 
     std::shared_ptr<SharedMemory> SharedMemoryCache::Open(const char* name)
@@ -111,4 +312,14 @@ namespace IPC
         return m_impl->Open(name);
     }
 
+    auto SharedMemoryCache::GetStatistics() const -> Statistics
+    {
+        return m_impl->GetStatistics();
+    }
+
+    void SharedMemoryCache::Clear()
+    {
+        m_impl->Clear();
+    }
+
 } // IPC
@@ -1,25 +1,49 @@
 #include "stdafx.h"
 #include "IPC/detail/ChannelFactory.h"
+#include "IPC/detail/KernelObject.h"
 
 
 namespace IPC
 {
     namespace detail
     {
+        namespace
+        {
+            /// Closes a section handle passed by the peer which is not needed.
+            void CloseSection(std::uint64_t section)
+            {
+                if (section != 0)
+                {
+                    KernelObject{ reinterpret_cast<void*>(static_cast<std::uintptr_t>(section)) };
+                }
+            }
+        }
+
+
+        std::uint64_t ChannelFactory<void>::InstanceBase::ShareMemory(const SharedMemory& memory, std::uint32_t processId)
+        {
+            return memory.GetName().empty() ? memory.Share(processId) : 0;
+        }
+
+        void ChannelFactory<void>::InstanceBase::UnshareMemory(std::uint64_t section, std::uint32_t processId) noexcept
+        {
+            SharedMemory::Unshare(section, processId);
+        }
+
         std::shared_ptr<SharedMemory> ChannelFactory<void>::InstanceBase::GetMemory(
             create_only_t, bool input, const char* name, const ChannelSettingsBase& settings)
         {
-            return GetMemory(false, input, name, settings);
+            return GetMemory(false, input, name, 0, settings);
         }
 
         std::shared_ptr<SharedMemory> ChannelFactory<void>::InstanceBase::GetMemory(
-            open_only_t, bool input, const char* name, const ChannelSettingsBase& settings)
+            open_only_t, bool input, const char* name, std::uint64_t section, const ChannelSettingsBase& settings)
         {
-            return GetMemory(true, input, name, settings);
+            return GetMemory(true, input, name, section, settings);
         }
 
         std::shared_ptr<SharedMemory> ChannelFactory<void>::InstanceBase::GetMemory(
-            bool open, bool input, const char* name, const ChannelSettingsBase& settings)
+            bool open, bool input, const char* name, std::uint64_t section, const ChannelSettingsBase& settings)
         {
             const auto& config = settings.GetConfig();
             const auto& channelConfig = input ? config.m_input : config.m_output;
@@ -28,15 +52,43 @@ namespace IPC
             {
                 if (auto memory = m_current.lock())
                 {
+                    CloseSection(section);  // The peer shares the same memory for every channel.
                     return memory;
                 }
             }
 
-            auto memory = channelConfig.m_common
-                ? channelConfig.m_common
-                : open
-                    ? settings.GetMemoryCache()->Open(name)
-                    : settings.GetMemoryCache()->Create(name, channelConfig.m_size);
+            std::shared_ptr<SharedMemory> memory;
+
+            if (channelConfig.m_common)
+            {
+                CloseSection(section);
+                memory = channelConfig.m_common;
+            }
+            else if (section != 0)
+            {
+                memory = std::make_shared<SharedMemory>(open_only, section);
+            }
+            else if (open)
+            {
+                memory = settings.GetMemoryCache()->Open(name);
+            }
+            else if (config.m_anonymous)
+            {
+                memory = std::make_shared<SharedMemory>(create_only, nullptr, channelConfig.m_size, channelConfig.m_options);
+            }
+            else
+            {
+                memory = settings.GetMemoryCache()->Create(name, channelConfig.m_size, channelConfig.m_options);
+            }
+
+            const auto& options = channelConfig.m_options;
+
+            if (open && !channelConfig.m_common && (options.m_prefault || options.m_lockPages))
+            {
+                // The creation options only fault the pages in for the creator. Memory returned again
+                // by the cache was already touched, so only the first open in this process walks it.
+                memory->Prefault(options.m_lockPages);
+            }
 
             if (config.m_shared)
             {
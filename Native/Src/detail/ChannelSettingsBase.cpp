@@ -11,23 +11,25 @@ namespace IPC
             : m_cache{ cache ? std::move(cache) : std::make_shared<SharedMemoryCache>() }
         {}
 
-        void ChannelSettingsBase::SetInput(std::size_t memorySize, bool allowOverride)
+        void ChannelSettingsBase::SetInput(std::size_t memorySize, bool allowOverride, const SharedMemory::Options& options)
         {
             m_config.m_shared = false;
 
             auto& input = m_config.m_input;
             input.m_common = {};
             input.m_size = memorySize;
+            input.m_options = options;
             input.m_allowOverride = allowOverride;
         }
 
-        void ChannelSettingsBase::SetOutput(std::size_t memorySize, bool allowOverride)
+        void ChannelSettingsBase::SetOutput(std::size_t memorySize, bool allowOverride, const SharedMemory::Options& options)
         {
             m_config.m_shared = false;
 
             auto& output = m_config.m_output;
             output.m_common = {};
             output.m_size = memorySize;
+            output.m_options = options;
             output.m_allowOverride = allowOverride;
         }
 
@@ -55,13 +57,14 @@ namespace IPC
             output.m_allowOverride = allowOverride;
         }
 
-        void ChannelSettingsBase::SetInputOutput(std::size_t memorySize, bool allowOverride)
+        void ChannelSettingsBase::SetInputOutput(std::size_t memorySize, bool allowOverride, const SharedMemory::Options& options)
         {
             m_config.m_shared = true;
 
             auto& input = m_config.m_input;
             input.m_common = {};
             input.m_size = memorySize;
+            input.m_options = options;
             input.m_allowOverride = allowOverride;
 
             m_config.m_output = input;
@@ -106,6 +109,36 @@ namespace IPC
             return m_config.m_shared;
         }
 
+        void ChannelSettingsBase::SetReceiverSpinDuration(std::chrono::microseconds duration)
+        {
+            m_config.m_receiverSpinDuration = duration;
+        }
+
+        std::chrono::microseconds ChannelSettingsBase::GetReceiverSpinDuration() const
+        {
+            return m_config.m_receiverSpinDuration;
+        }
+
+        void ChannelSettingsBase::SetAnonymousMemory(bool anonymous)
+        {
+            m_config.m_anonymous = anonymous;
+        }
+
+        bool ChannelSettingsBase::IsAnonymousMemory() const
+        {
+            return m_config.m_anonymous;
+        }
+
+        void ChannelSettingsBase::SetBucketReclamation(bool reclaim)
+        {
+            m_config.m_reclaimBuckets = reclaim;
+        }
+
+        bool ChannelSettingsBase::IsBucketReclamationEnabled() const
+        {
+            return m_config.m_reclaimBuckets;
+        }
+
         const std::shared_ptr<SharedMemoryCache>& ChannelSettingsBase::GetMemoryCache() const
         {
             return m_cache;
@@ -0,0 +1,96 @@
+#include "stdafx.h"
+#include "IPC/detail/Completion.h"
+#include <algorithm>
+
+#pragma comment(lib, "Synchronization.lib")
+
+
+namespace IPC
+{
+    namespace detail
+    {
+        void CompletionBase::Wait() const
+        {
+            if (Spin())
+            {
+                return;
+            }
+
+            for (auto flags = m_flags.load(std::memory_order_acquire); (flags & Ready) == 0; flags = m_flags.load(std::memory_order_acquire))
+            {
+                if ((flags & Waiting) != 0 || m_flags.compare_exchange_weak(flags, flags | Waiting, std::memory_order_acquire))
+                {
+                    flags |= Waiting;
+                    ::WaitOnAddress(&m_flags, &flags, sizeof(flags), INFINITE);
+                }
+            }
+        }
+
+        bool CompletionBase::WaitUntil(const std::chrono::steady_clock::time_point& deadline) const
+        {
+            if (Spin())
+            {
+                return true;
+            }
+
+            for (auto flags = m_flags.load(std::memory_order_acquire); (flags & Ready) == 0; flags = m_flags.load(std::memory_order_acquire))
+            {
+                auto now = std::chrono::steady_clock::now();
+
+                if (now >= deadline)
+                {
+                    return false;
+                }
+
+                if ((flags & Waiting) != 0 || m_flags.compare_exchange_weak(flags, flags | Waiting, std::memory_order_acquire))
+                {
+                    // Rounds up, so the wait does not turn into spinning for the last millisecond.
+                    auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now + std::chrono::milliseconds{ 1 } - std::chrono::nanoseconds{ 1 });
+
+                    flags |= Waiting;
+                    ::WaitOnAddress(&m_flags, &flags, sizeof(flags), static_cast<DWORD>((std::min)(timeout.count(), std::chrono::milliseconds::rep{ INFINITE - 1 })));
+                }
+            }
+
+            return true;
+        }
+
+        bool CompletionBase::SetReady()
+        {
+            auto flags = m_flags.fetch_or(Ready, std::memory_order_acq_rel);
+
+            if ((flags & Waiting) != 0)
+            {
+                ::WakeByAddressAll(&m_flags);
+            }
+
+            return (flags & Continuation) != 0;
+        }
+
+        bool CompletionBase::SetContinuation()
+        {
+            return (m_flags.fetch_or(Continuation, std::memory_order_acq_rel) & Ready) != 0;
+        }
+
+        void CompletionBase::ResetFlags()
+        {
+            m_flags.store(0, std::memory_order_release);
+        }
+
+        bool CompletionBase::Spin() const
+        {
+            for (std::size_t count{ 0 }; count != c_maxSpinCount; ++count)
+            {
+                if (IsReady())
+                {
+                    return true;
+                }
+
+                ::YieldProcessor();
+            }
+
+            return IsReady();
+        }
+
+    } // detail
+} // IPC
@@ -6,6 +6,12 @@ namespace IPC
 {
     namespace detail
     {
+        AcceptorSlot::AcceptorSlot(const String::allocator_type& allocator)
+            : m_closeEventName{ allocator },
+              m_acceptorChannelName{ allocator },
+              m_connectorChannelName{ allocator }
+        {}
+
         AcceptorHostInfo::AcceptorHostInfo(const String::allocator_type& allocator)
             : m_acceptorCloseEventName{ allocator }
         {}
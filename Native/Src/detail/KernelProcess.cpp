@@ -7,9 +7,15 @@ namespace IPC
 namespace detail
 {
     KernelProcess::KernelProcess(std::uint32_t pid)
-        : KernelObject{ ::OpenProcess(SYNCHRONIZE, false, pid) }
+        : KernelObject{ ::OpenProcess(SYNCHRONIZE, false, pid) },
+          m_id{ pid }
     {}
 
+    std::uint32_t KernelProcess::GetId() const
+    {
+        return m_id;
+    }
+
     std::uint32_t KernelProcess::GetCurrentProcessId()
     {
         return ::GetCurrentProcessId();
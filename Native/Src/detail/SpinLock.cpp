@@ -1,7 +1,8 @@
 #include "stdafx.h"
 #include "IPC/detail/SpinLock.h"
 #include <thread>
-#include <chrono>
+
+#pragma comment(lib, "Synchronization.lib")
 
 
 namespace IPC
@@ -10,36 +11,39 @@ namespace IPC
     {
         void SpinLock::lock()
         {
-            std::size_t count{ 0 };
-            bool locked{ false };
-
-            while (++count <= c_maxYieldCount)
+            for (std::size_t count{ 0 }; count != c_maxYieldCount; ++count)
             {
-                if (m_lock.test_and_set(std::memory_order_acquire))
-                {
-                    std::this_thread::yield();
-                }
-                else
+                if (try_lock())
                 {
-                    locked = true;
-                    break;
+                    return;
                 }
+
+                std::this_thread::yield();
             }
 
-            if (!locked)
+            while (m_state.exchange(Contended, std::memory_order_acquire) != Unlocked)
             {
-                std::chrono::milliseconds delay{ c_sleepDuration };
-
-                while (m_lock.test_and_set(std::memory_order_acquire))
-                {
-                    std::this_thread::sleep_for(delay);
-                }
+                // The ::WaitOnAddress is only woken up from within the same process,
+                // so the timeout bounds the latency for waiters in other processes.
+                std::uint32_t state{ Contended };
+                ::WaitOnAddress(&m_state, &state, sizeof(state), c_waitTimeout);
             }
         }
 
+        bool SpinLock::try_lock()
+        {
+            std::uint32_t state{ Unlocked };
+
+            return m_state.load(std::memory_order_relaxed) == Unlocked
+                && m_state.compare_exchange_strong(state, Locked, std::memory_order_acquire, std::memory_order_relaxed);
+        }
+
         void SpinLock::unlock()
         {
-            m_lock.clear(std::memory_order_release);
+            if (m_state.exchange(Unlocked, std::memory_order_release) == Contended)
+            {
+                ::WakeByAddressSingle(&m_state);
+            }
         }
 
     } // detail
@@ -0,0 +1,65 @@
+#include "stdafx.h"
+#include "AllocationCounter.h"
+#include <atomic>
+#include <new>
+#include <cstdlib>
+
+
+static std::atomic_size_t g_allocationCount{ 0 };
+static std::atomic_size_t g_lastGeneration{ 0 };
+static std::atomic_size_t g_activeGeneration{ 0 };     // Zero when no counter is active.
+static thread_local std::size_t t_generation{ 0 };     // Generation of the counter the thread is attached to.
+
+
+void* operator new(std::size_t size)
+{
+    if (t_generation != 0 && t_generation == g_activeGeneration.load(std::memory_order_relaxed))
+    {
+        g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (auto ptr = std::malloc(size != 0 ? size : 1))
+    {
+        return ptr;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+
+namespace IPC
+{
+namespace UnitTest
+{
+    AllocationCounter::AllocationCounter()
+        : m_generation{ ++g_lastGeneration }
+    {
+        g_activeGeneration = m_generation;
+        Attach();
+        m_start = g_allocationCount.load();
+    }
+
+    AllocationCounter::~AllocationCounter()
+    {
+        auto generation = m_generation;
+        g_activeGeneration.compare_exchange_strong(generation, 0);
+    }
+
+    void AllocationCounter::Attach() const
+    {
+        t_generation = m_generation;
+    }
+
+    std::size_t AllocationCounter::GetCount() const
+    {
+        return g_allocationCount.load() - m_start;
+    }
+
+
+} // UnitTest
+} // IPC
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+
+
+namespace IPC
+{
+namespace UnitTest
+{
+    /// Counts the global operator new calls made since construction by the threads attached
+    /// to this counter. The constructing thread is attached, others attach with Attach, so
+    /// allocations of unrelated background threads are not counted. Only the most recently
+    /// constructed counter is active.
+    class AllocationCounter
+    {
+    public:
+        AllocationCounter();
+
+        AllocationCounter(const AllocationCounter& other) = delete;
+        AllocationCounter& operator=(const AllocationCounter& other) = delete;
+
+        ~AllocationCounter();
+
+        /// Starts counting the allocations of the calling thread.
+        void Attach() const;
+
+        std::size_t GetCount() const;
+
+    private:
+        std::size_t m_generation;
+        std::size_t m_start;
+    };
+
+
+} // UnitTest
+} // IPC
@@ -0,0 +1,164 @@
+#include "stdafx.h"
+#include "IPC/Policies/BusyPollReceiverFactory.h"
+#include <vector>
+#include <queue>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <atomic>
+
+using namespace IPC;
+
+
+BOOST_AUTO_TEST_SUITE(BusyPollReceiverFactoryTests)
+
+struct Queue : std::queue<int>, private std::mutex
+{
+    template <typename Function>
+    std::size_t ConsumeAll(Function&& func)
+    {
+        std::size_t count{ 0 };
+
+        for (std::unique_lock<std::mutex> guard{ *this }; !empty(); ++count)
+        {
+            auto x = front();
+            pop();
+
+            guard.unlock();
+            func(x);
+            guard.lock();
+        }
+
+        return count;
+    }
+
+    void Push(int x)
+    {
+        std::lock_guard<std::mutex> guard{ *this };
+        push(x);
+    }
+};
+
+BOOST_AUTO_TEST_CASE(InvocationTest)
+{
+    Policies::BusyPollReceiverFactory factory;
+
+    Queue queue;
+    queue.Push(1);
+    queue.Push(2);
+
+    std::mutex lock;
+    std::vector<int> values;
+    std::condition_variable cvProcessed;
+
+    auto poller = factory.Poll(
+        factory(
+            queue,
+            [&](int x)
+            {
+                std::lock_guard<std::mutex> guard{ lock };
+                values.push_back(x);
+                cvProcessed.notify_one();
+            }));
+
+    {
+        std::unique_lock<std::mutex> guard{ lock };
+        cvProcessed.wait(guard, [&] { return values.size() == 2; });
+    }
+
+    queue.Push(3);
+    {
+        std::unique_lock<std::mutex> guard{ lock };
+        cvProcessed.wait(guard, [&] { return values.size() == 3; });
+    }
+
+    BOOST_TEST((values == std::vector<int>{ 1, 2, 3 }));
+}
+
+BOOST_AUTO_TEST_CASE(MultiplePollersTest)
+{
+    Policies::BusyPollReceiverFactory factory{ 0, { 1, 1, std::chrono::microseconds{ 100 } } };
+
+    std::atomic_size_t count1{ 0 }, count2{ 0 };
+
+    auto poller1 = factory.Poll([&] { ++count1; return std::size_t{ 0 }; });
+    auto poller2 = factory.Poll([&] { ++count2; return std::size_t{ 0 }; });
+
+    while (count1 < 10 || count2 < 10)
+    {
+        std::this_thread::yield();
+    }
+
+    poller1 = {};
+
+    auto count = count1.load();
+
+    for (auto n = count2.load(); count2 < n + 10; )
+    {
+        std::this_thread::yield();
+    }
+
+    BOOST_TEST(count1 == count);
+}
+
+BOOST_AUTO_TEST_CASE(BlockedPollTest)
+{
+    Policies::BusyPollReceiverFactory factory;
+
+    std::promise<void> started, release;
+    auto releaseFuture = release.get_future();
+    std::atomic_size_t count{ 0 };
+
+    auto poller = factory.Poll(
+        [&]
+        {
+            if (count++ == 0)
+            {
+                started.set_value();
+                releaseFuture.wait();
+            }
+
+            return std::size_t{ 1 };
+        });
+
+    started.get_future().wait();
+
+    auto result = std::async(std::launch::async, [&] { poller = {}; return true; });
+
+    BOOST_TEST((result.wait_for(std::chrono::milliseconds{ 1 }) == std::future_status::timeout));
+    release.set_value();
+    BOOST_TEST(result.get());
+
+    auto n = count.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+    BOOST_TEST(count == n);
+}
+
+BOOST_AUTO_TEST_CASE(SelfDestructionTest)
+{
+    auto factory = std::make_unique<Policies::BusyPollReceiverFactory>();
+
+    std::mutex lock;
+    std::condition_variable cvDone;
+    std::shared_ptr<void> poller;
+    bool done = false;
+
+    std::unique_lock<std::mutex> guard{ lock };
+
+    poller = factory->Poll(
+        [&]
+        {
+            std::lock_guard<std::mutex> callbackGuard{ lock };
+            poller = {};
+            done = true;
+            cvDone.notify_one();
+            return std::size_t{ 0 };
+        });
+
+    factory.reset();
+
+    cvDone.wait(guard, [&] { return done; });
+    BOOST_TEST(!poller);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
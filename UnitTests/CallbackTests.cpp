@@ -1,6 +1,8 @@
 #include "stdafx.h"
 #include "IPC/detail/Callback.h"
+#include "AllocationCounter.h"
 #include <memory>
+#include <array>
 #include <type_traits>
 
 using namespace IPC;
@@ -55,4 +57,65 @@ BOOST_AUTO_TEST_CASE(CopyableObjectCaptureTest)
     }
 }
 
+BOOST_AUTO_TEST_CASE(InlineStorageTest)
+{
+    auto value = std::make_shared<int>(123);
+    std::array<char, 32> data{};
+    int result = 0;
+
+    {
+        UnitTest::AllocationCounter allocations;
+
+        detail::Callback<void(int)> callback{ [value, data, &result](int x) { result = *value + data[0] + x; } };
+        auto other = std::move(callback);
+        callback = std::move(other);
+        callback(1);
+
+        BOOST_TEST(allocations.GetCount() == 0);
+    }
+
+    BOOST_TEST(result == 124);
+    BOOST_TEST(value.use_count() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(LargeObjectCaptureTest)
+{
+    auto value = std::make_shared<int>(123);
+    std::array<char, 256> data{};
+    data.back() = 1;
+
+    {
+        UnitTest::AllocationCounter allocations;
+
+        detail::Callback<int()> callback{ [value, data] { return *value + data.back(); } };
+        BOOST_TEST(allocations.GetCount() == 1);
+
+        auto other = std::move(callback);
+        BOOST_TEST(!callback);
+        BOOST_TEST(other() == 124);
+        BOOST_TEST(value.use_count() == 2);
+    }
+
+    BOOST_TEST(value.use_count() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(MutableObjectCaptureTest)
+{
+    const detail::Callback<int()> callback{ [x = 0]() mutable { return ++x; } };
+
+    BOOST_TEST(callback() == 1);
+    BOOST_TEST(callback() == 2);
+}
+
+BOOST_AUTO_TEST_CASE(FunctionPointerTest)
+{
+    int (*func)(int) = [](int x) { return x + 1; };
+
+    detail::Callback<int(int)> callback{ func };
+    BOOST_TEST(callback(1) == 2);
+
+    func = nullptr;
+    BOOST_TEST(!detail::Callback<int(int)>{ func });
+}
+
 BOOST_AUTO_TEST_SUITE_END()
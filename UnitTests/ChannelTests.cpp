@@ -2,15 +2,21 @@
 #include "IPC/OutputChannel.h"
 #include "IPC/InputChannel.h"
 #include "IPC/detail/RandomString.h"
+#include "IPC/detail/LockFree/RingQueue.h"
+#include "IPC/detail/LockFree/Queue.h"
+#include "IPC/Policies/BusyPollReceiverFactory.h"
 #include "TraitsMock.h"
 #include <memory>
 #include <bitset>
 #include <array>
+#include <vector>
+#include <numeric>
 #include <mutex>
 #include <condition_variable>
 #include <future>
 #include <thread>
 #include <type_traits>
+#include <stdexcept>
 #include <cassert>
 
 using namespace IPC;
@@ -332,6 +338,273 @@ BOOST_AUTO_TEST_CASE(MemoryOwnershipTest)
         }));
 }
 
+BOOST_AUTO_TEST_CASE(BatchSendTest)
+{
+    auto name = detail::GenerateRandomString();
+    auto memory = std::make_shared<SharedMemory>(create_only, name.c_str(), c_memSize);
+
+    Traits::WaitHandleFactory waitHandleFactory;
+
+    InputChannel<int, Traits> in{ create_only, name.c_str(), memory, waitHandleFactory };
+    OutputChannel<int, Traits> out{ open_only, name.c_str(), memory };
+
+    std::bitset<c_queueLimit> bits;
+    BOOST_TEST(in.RegisterReceiver([&](int i) { assert(!bits.test(i)); bits.set(i); }));
+
+    std::vector<int> values(c_queueLimit + 5);
+    std::iota(values.begin(), values.end(), 0);
+
+    BOOST_TEST(out.TrySendRange(values.begin(), values.end()) == c_queueLimit);
+    BOOST_TEST(out.TrySendRange(values.begin(), values.end()) == 0);
+    BOOST_CHECK_THROW(out.SendBatch(values.begin(), values.begin() + 1), std::exception);
+
+    BOOST_TEST(waitHandleFactory.Process() == 1);
+
+    BOOST_TEST(bits.all());
+    BOOST_TEST(in.IsEmpty());
+
+    bits.reset();
+    BOOST_CHECK_NO_THROW(out.SendBatch(values.begin(), values.begin() + 2));
+
+    BOOST_TEST(waitHandleFactory.Process() == 1);
+    BOOST_TEST(bits.count() == 2);
+}
+
+struct BucketTraits : Traits
+{
+    template <typename T, typename Allocator>
+    class Queue : public detail::LockFree::Queue<T, Allocator, 4>
+    {
+    public:
+        explicit Queue(const Allocator& allocator, bool reclaimable = false)
+            : detail::LockFree::Queue<T, Allocator, 4>{ allocator, reclaimable }
+        {}
+    };
+};
+
+BOOST_AUTO_TEST_CASE(BucketReclamationTest)
+{
+    auto name = detail::GenerateRandomString();
+    auto memory = std::make_shared<SharedMemory>(create_only, name.c_str(), c_memSize);
+
+    auto freeSize = memory->GetFreeSize();
+
+    auto burst = [&](auto& in, auto& out)
+    {
+        for (int i = 0; i < 40; ++i)
+        {
+            BOOST_TEST(out.TrySend(i));
+        }
+
+        BOOST_TEST(memory->GetFreeSize() < freeSize);
+        BOOST_TEST(in.ReceiveAll([](int) {}) == 40);
+
+        for (int i = 0; i < 10; ++i)    // Every drain releases at most half of the idle buckets.
+        {
+            BOOST_TEST(in.ReceiveAll([](int) {}) == 0);
+        }
+    };
+
+    {
+        InputChannel<int, BucketTraits> in{ create_only, name.c_str(), memory, {}, {}, true };
+        OutputChannel<int, BucketTraits> out{ open_only, name.c_str(), memory };
+        freeSize = memory->GetFreeSize();
+
+        burst(in, out);
+        BOOST_TEST(memory->GetFreeSize() == freeSize);
+    }
+
+    name = detail::GenerateRandomString();
+
+    InputChannel<int, BucketTraits> in{ create_only, name.c_str(), memory };
+    OutputChannel<int, BucketTraits> out{ open_only, name.c_str(), memory };
+    freeSize = memory->GetFreeSize();
+
+    burst(in, out);
+    BOOST_TEST(memory->GetFreeSize() < freeSize);  // Buckets are kept by default.
+}
+
+BOOST_AUTO_TEST_CASE(BatchSendExceptionSafetyTest)
+{
+    struct X
+    {
+        X(int value, bool doThrow)
+            : m_value{ value },
+              m_throw{ doThrow }
+        {}
+
+        X(const X& other)
+            : m_value{ other.m_value },
+              m_throw{ other.m_throw }
+        {
+            if (m_throw)
+            {
+                throw std::runtime_error{ "Copy failed." };
+            }
+        }
+
+        X& operator=(const X& other)
+        {
+            m_value = other.m_value;
+            m_throw = other.m_throw;
+
+            return *this;
+        }
+
+        int m_value;
+        bool m_throw;
+    };
+
+    auto name = detail::GenerateRandomString();
+    auto memory = std::make_shared<SharedMemory>(create_only, name.c_str(), c_memSize);
+
+    BucketTraits::WaitHandleFactory waitHandleFactory;
+
+    InputChannel<X, BucketTraits> in{ create_only, name.c_str(), memory, waitHandleFactory };
+    OutputChannel<X, BucketTraits> out{ open_only, name.c_str(), memory };
+
+    std::size_t count{ 0 };
+    BOOST_TEST(in.RegisterReceiver([&](X&&) { ++count; }));
+
+    std::vector<X> values;
+    values.reserve(6);
+    for (int i = 0; i < 6; ++i)
+    {
+        values.emplace_back(i, i == 5);
+    }
+
+    BOOST_TEST(out.TrySendRange(values.begin(), values.end()) == 4);    // The failed bucket is not published.
+    BOOST_CHECK_THROW(out.TrySendRange(values.begin() + 4, values.end()), std::runtime_error);
+    BOOST_CHECK_THROW(out.SendBatch(values.begin() + 4, values.end()), std::runtime_error);
+
+    BOOST_TEST(waitHandleFactory.Process() == 1);   // Would not return if the counter missed published elements.
+    BOOST_TEST(count == 4);
+    BOOST_TEST(in.IsEmpty());
+
+    values.back().m_throw = false;
+    BOOST_CHECK_NO_THROW(out.SendBatch(values.begin(), values.end()));
+
+    BOOST_TEST(waitHandleFactory.Process() == 1);
+    BOOST_TEST(count == 10);
+    BOOST_TEST(in.IsEmpty());
+}
+
+BOOST_AUTO_TEST_CASE(SpinReceiveTest)
+{
+    auto name = detail::GenerateRandomString();
+    auto memory = std::make_shared<SharedMemory>(create_only, name.c_str(), c_memSize);
+
+    Traits::WaitHandleFactory waitHandleFactory;
+
+    InputChannel<int, Traits> in{ create_only, name.c_str(), memory, waitHandleFactory };
+    OutputChannel<int, Traits> out{ open_only, name.c_str(), memory };
+
+    in.SetSpinDuration(std::chrono::milliseconds{ 500 });
+    BOOST_TEST(in.GetSpinDuration().count() != 0);
+
+    std::atomic_size_t count{ 0 };
+    BOOST_TEST(in.RegisterReceiver([&](int) { ++count; }));
+
+    out.Send(0);
+
+    auto sender = std::async(
+        std::launch::async,
+        [&]
+        {
+            while (count == 0)
+            {
+                std::this_thread::yield();
+            }
+
+            out.Send(1);    // Picked up by the spinning receiver without a signal.
+        });
+
+    BOOST_TEST(waitHandleFactory.Process() == 1);
+    sender.get();
+
+    BOOST_TEST(count == 2);
+    BOOST_TEST(in.IsEmpty());
+    BOOST_TEST(waitHandleFactory.Process() == 0);
+
+    out.Send(2);    // Receiver is no longer spinning, so the event is signaled again.
+
+    BOOST_TEST(waitHandleFactory.Process() == 1);
+    BOOST_TEST(count == 3);
+}
+
+BOOST_AUTO_TEST_CASE(BusyPollReceiveTest)
+{
+    struct BusyPollTraits : Traits
+    {
+        using ReceiverFactory = Policies::BusyPollReceiverFactory;
+    };
+
+    auto name = detail::GenerateRandomString();
+    auto memory = std::make_shared<SharedMemory>(create_only, name.c_str(), c_memSize);
+
+    BusyPollTraits::WaitHandleFactory waitHandleFactory;
+
+    InputChannel<int, BusyPollTraits> in{ create_only, name.c_str(), memory, waitHandleFactory };
+    OutputChannel<int, BusyPollTraits> out{ open_only, name.c_str(), memory };
+
+    std::atomic_size_t count{ 0 };
+    BOOST_TEST(in.RegisterReceiver([&](int) { ++count; }));
+
+    for (int i = 0; i < 3; ++i)
+    {
+        out.Send(i);
+
+        while (count != static_cast<std::size_t>(i + 1))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    BOOST_TEST(waitHandleFactory.Process() == 0);
+    BOOST_TEST(in.IsEmpty());
+
+    BOOST_TEST(in.UnregisterReceiver());
+
+    out.Send(3);
+    BOOST_TEST(!in.IsEmpty());
+    BOOST_TEST(count == 3);
+}
+
+struct RingQueueTraits : Traits
+{
+    template <typename T, typename Allocator>
+    using Queue = detail::LockFree::RingQueue<T, Allocator, 32>;
+};
+
+BOOST_AUTO_TEST_CASE(RingQueueTest)
+{
+    auto name = detail::GenerateRandomString();
+    auto memory = std::make_shared<SharedMemory>(create_only, name.c_str(), c_memSize);
+
+    RingQueueTraits::WaitHandleFactory waitHandleFactory;
+
+    InputChannel<int, RingQueueTraits> in{ create_only, name.c_str(), memory, waitHandleFactory };
+    BOOST_TEST(in.IsEmpty());
+    OutputChannel<int, RingQueueTraits> out{ open_only, name.c_str(), memory };
+    BOOST_TEST(out.IsEmpty());
+
+    std::bitset<32> bits;
+    BOOST_TEST(in.RegisterReceiver([&](int i) { assert(!bits.test(i)); bits.set(i); }));
+
+    for (int i = 0; i < 32; ++i)
+    {
+        out.Send(i);
+    }
+
+    BOOST_TEST(!out.TrySend(0));
+
+    BOOST_TEST(waitHandleFactory.Process() != 0);
+
+    BOOST_TEST(bits.all());
+    BOOST_TEST(in.IsEmpty());
+    BOOST_TEST(out.IsEmpty());
+}
+
 BOOST_AUTO_TEST_CASE(StressTest)
 {
     constexpr std::size_t ThreadCount = 5;
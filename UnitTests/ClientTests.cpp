@@ -2,8 +2,11 @@
 #include "IPC/Client.h"
 #include "IPC/detail/RandomString.h"
 #include "TraitsMock.h"
+#include "AllocationCounter.h"
 #include <type_traits>
 #include <memory>
+#include <vector>
+#include <numeric>
 
 using namespace IPC;
 
@@ -124,6 +127,110 @@ BOOST_AUTO_TEST_CASE(HandlerWithResponseInvocationTest)
     BOOST_TEST(closed);
 }
 
+BOOST_AUTO_TEST_CASE(CompletionInvocationTest)
+{
+    detail::KernelEvent closeEvent{ create_only, false };
+    auto names = std::make_pair(detail::GenerateRandomString(), detail::GenerateRandomString());
+    auto memory = std::make_shared<SharedMemory>(create_only, detail::GenerateRandomString().c_str(), c_memSize);
+
+    Traits::WaitHandleFactory waitHandleFactory;
+
+    Client<int, int, Traits> client{
+        std::make_unique<Client<int, int, Traits>::Connection>(
+            closeEvent, closeEvent, closeEvent, waitHandleFactory,
+            InputChannel<detail::ClientTraits<int, int, Traits>::InputPacket, Traits>{ create_only, names.first.c_str(), memory, waitHandleFactory },
+            OutputChannel<detail::ClientTraits<int, int, Traits>::OutputPacket, Traits>{ create_only, names.second.c_str(), memory }),
+        [] {} };
+
+    auto result = client.Call(333);
+    BOOST_TEST(result.valid());
+    BOOST_TEST((result.wait_for(std::chrono::milliseconds{ 1 }) == std::future_status::timeout));
+
+    int continuationValue = 0;
+    client.Call(444).then([&](Completion<int>&& completion) { continuationValue = completion.get(); });
+
+    std::vector<Traits::PacketId> ids;
+    BOOST_TEST(2 == (InputChannel<detail::ClientTraits<int, int, Traits>::OutputPacket, Traits>{ open_only, names.second.c_str(), memory, waitHandleFactory }
+        .ReceiveAll([&](auto&& packet)
+        {
+            ids.push_back(packet.GetId());
+        })));
+
+    OutputChannel<detail::ClientTraits<int, int, Traits>::InputPacket, Traits> output{ open_only, names.first.c_str(), memory };
+    output.Send(detail::ClientTraits<int, int, Traits>::InputPacket{ ids[0], 111 });
+    output.Send(detail::ClientTraits<int, int, Traits>::InputPacket{ ids[1], 222 });
+
+    BOOST_TEST(waitHandleFactory.Process() != 0);
+    BOOST_TEST(result.get() == 111);
+    BOOST_TEST(continuationValue == 222);
+}
+
+BOOST_AUTO_TEST_CASE(BatchInvocationTest)
+{
+    detail::KernelEvent closeEvent{ create_only, false };
+    auto names = std::make_pair(detail::GenerateRandomString(), detail::GenerateRandomString());
+    auto memory = std::make_shared<SharedMemory>(create_only, detail::GenerateRandomString().c_str(), c_memSize);
+
+    Traits::WaitHandleFactory waitHandleFactory;
+
+    Client<int, int, Traits> client{
+        std::make_unique<Client<int, int, Traits>::Connection>(
+            closeEvent, closeEvent, closeEvent, waitHandleFactory,
+            InputChannel<detail::ClientTraits<int, int, Traits>::InputPacket, Traits>{ create_only, names.first.c_str(), memory, waitHandleFactory },
+            OutputChannel<detail::ClientTraits<int, int, Traits>::OutputPacket, Traits>{ create_only, names.second.c_str(), memory }),
+        [] {} };
+
+    std::vector<int> requests(c_queueLimit + 5);
+    std::iota(requests.begin(), requests.end(), 0);
+
+    int sum{ 0 };
+    BOOST_TEST(client.TrySendRange(requests.begin(), requests.end(), [&](int response) { sum += response; }) == c_queueLimit);
+
+    OutputChannel<detail::ClientTraits<int, int, Traits>::InputPacket, Traits> out{ open_only, names.first.c_str(), memory };
+
+    BOOST_TEST(c_queueLimit == (InputChannel<detail::ClientTraits<int, int, Traits>::OutputPacket, Traits>{ open_only, names.second.c_str(), memory, waitHandleFactory }
+        .ReceiveAll([&](auto&& packet)
+        {
+            out.Send(detail::ClientTraits<int, int, Traits>::InputPacket{ packet.GetId(), packet.GetPayload() });
+        })));
+
+    BOOST_TEST(waitHandleFactory.Process() != 0);
+    BOOST_TEST(sum == (c_queueLimit * (c_queueLimit - 1)) / 2);
+}
+
+BOOST_AUTO_TEST_CASE(BatchBufferReuseTest)
+{
+    detail::KernelEvent closeEvent{ create_only, false };
+    auto name = detail::GenerateRandomString();
+    auto memory = std::make_shared<SharedMemory>(create_only, name.c_str(), c_memSize);
+
+    Client<int, void, Traits> client{
+        std::make_unique<Client<int, void, Traits>::Connection>(
+            closeEvent, closeEvent, closeEvent, Traits::WaitHandleFactory{},
+            OutputChannel<detail::ClientTraits<int, void, Traits>::OutputPacket, Traits>{ create_only, name.c_str(), memory }),
+        [] {} };
+
+    InputChannel<detail::ClientTraits<int, void, Traits>::OutputPacket, Traits> in{ open_only, name.c_str(), memory };
+
+    std::vector<int> requests(c_queueLimit);
+    std::iota(requests.begin(), requests.end(), 0);
+
+    auto sendAndReceive = [&]
+    {
+        return client.TrySendRange(requests.begin(), requests.end()) == c_queueLimit
+            && in.ReceiveAll([](auto&& /*packet*/) {}) == c_queueLimit;
+    };
+
+    BOOST_TEST(sendAndReceive());
+
+    UnitTest::AllocationCounter allocations;
+    auto success = sendAndReceive();
+    auto allocationCount = allocations.GetCount();
+
+    BOOST_TEST(success);
+    BOOST_TEST(allocationCount == 0);
+}
+
 BOOST_AUTO_TEST_CASE(DestroyedWaitHandlesAfterDestructionTest)
 {
     detail::KernelEvent closeEvent{ create_only, false };
@@ -220,6 +327,28 @@ BOOST_AUTO_TEST_CASE(ClosedConnectionTransactionTerminationTest)
     BOOST_TEST(context.unique());
 }
 
+BOOST_AUTO_TEST_CASE(ClosedConnectionCompletionTerminationTest)
+{
+    detail::KernelEvent closeEvent{ create_only, false };
+    auto names = std::make_pair(detail::GenerateRandomString(), detail::GenerateRandomString());
+    auto memory = std::make_shared<SharedMemory>(create_only, detail::GenerateRandomString().c_str(), c_memSize);
+
+    Client<int, int, Traits> client{
+        std::make_unique<Client<int, int, Traits>::Connection>(
+            closeEvent, closeEvent, closeEvent, Traits::WaitHandleFactory{},
+            InputChannel<detail::ClientTraits<int, int, Traits>::InputPacket, Traits>{ create_only, names.first.c_str(), memory },
+            OutputChannel<detail::ClientTraits<int, int, Traits>::OutputPacket, Traits>{ create_only, names.second.c_str(), memory }),
+        [] {} };
+
+    auto result = client.Call(1);
+    BOOST_TEST((result.wait_for(std::chrono::milliseconds{ 1 }) == std::future_status::timeout));
+
+    client.GetConnection().Close();
+
+    BOOST_TEST(result.is_ready());
+    BOOST_CHECK_THROW(result.get(), std::future_error);
+}
+
 BOOST_AUTO_TEST_CASE(TransactionTerminationDuringDestructionTest)
 {
     bool invoked = false;
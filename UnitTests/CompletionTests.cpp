@@ -0,0 +1,133 @@
+#include "stdafx.h"
+#include "IPC/Completion.h"
+#include "AllocationCounter.h"
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <future>
+#include <chrono>
+#include <type_traits>
+
+using namespace IPC;
+
+
+BOOST_AUTO_TEST_SUITE(CompletionTests)
+
+static_assert(!std::is_copy_constructible<Completion<int>>::value, "Completion should not be copy constructible.");
+static_assert(std::is_move_constructible<Completion<int>>::value, "Completion should be move constructible.");
+
+BOOST_AUTO_TEST_CASE(ValueTest)
+{
+    auto completion = detail::MakeCompletion<int>();
+    auto& result = completion.first;
+
+    BOOST_TEST(result.valid());
+    BOOST_TEST(!result.is_ready());
+    BOOST_TEST((result.wait_for(std::chrono::milliseconds{ 1 }) == std::future_status::timeout));
+
+    completion.second(123);
+
+    BOOST_TEST(result.is_ready());
+    BOOST_TEST((result.wait_for(std::chrono::milliseconds{ 1 }) == std::future_status::ready));
+    BOOST_TEST(result.get() == 123);
+    BOOST_TEST(!result.valid());
+}
+
+BOOST_AUTO_TEST_CASE(BrokenPromiseTest)
+{
+    auto completion = detail::MakeCompletion<std::unique_ptr<int>>();
+    auto& result = completion.first;
+
+    {
+        auto source = std::move(completion.second);
+    }
+
+    BOOST_TEST(result.is_ready());
+    BOOST_CHECK_EXCEPTION(result.get(), std::future_error,
+        [](const std::future_error& e) { return e.code() == std::future_errc::broken_promise; });
+}
+
+BOOST_AUTO_TEST_CASE(ContinuationTest)
+{
+    {
+        auto completion = detail::MakeCompletion<int>();
+        int value = 0;
+
+        completion.first.then([&](Completion<int>&& result) { value = result.get(); });
+        BOOST_TEST(value == 0);
+
+        completion.second(1);
+        BOOST_TEST(value == 1);
+    }
+    {
+        auto completion = detail::MakeCompletion<int>();
+        int value = 0;
+
+        completion.second(2);
+
+        completion.first.then([&](Completion<int>&& result) { value = result.get(); });
+        BOOST_TEST(value == 2);
+    }
+    {
+        auto completion = detail::MakeCompletion<int>();
+        bool broken = false;
+
+        completion.first.then(
+            [&](Completion<int>&& result)
+            {
+                try
+                {
+                    result.get();
+                }
+                catch (const std::future_error&)
+                {
+                    broken = true;
+                }
+            });
+
+        completion.second = detail::CompletionSource<int>{ {} };     // Abandons the completion.
+        BOOST_TEST(broken);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentCompletionTest)
+{
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto completion = detail::MakeCompletion<int>();
+
+        std::thread producer{ [source = std::move(completion.second), i]() mutable { source(i); } };
+
+        BOOST_TEST(completion.first.get() == i);
+
+        producer.join();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(PooledStateTest)
+{
+    auto roundTrips = []
+    {
+        bool success = true;
+
+        for (int i = 0; i < 100; ++i)
+        {
+            auto completion = detail::MakeCompletion<int>();
+            completion.second(i);
+            success &= completion.first.get() == i;
+        }
+
+        return success;
+    };
+
+    BOOST_TEST(roundTrips());
+
+    UnitTest::AllocationCounter allocations;
+    auto success = roundTrips();
+    auto allocationCount = allocations.GetCount();
+
+    BOOST_TEST(success);
+    BOOST_TEST(allocationCount == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -2,8 +2,18 @@
 #include "IPC/Connect.h"
 #include "IPC/Connector.h"
 #include "IPC/Acceptor.h"
+#include "IPC/Accept.h"
+#include "IPC/DefaultTraits.h"
 #include "TraitsMock.h"
 #include "TimeoutFactoryMock.h"
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <functional>
 
 using namespace IPC;
 
@@ -35,6 +45,151 @@ BOOST_AUTO_TEST_CASE(SyncClientConnectionTest)
     BOOST_TEST(!clientAccessor()->GetConnection().IsClosed());
 }
 
+BOOST_AUTO_TEST_CASE(AnonymousMemoryConnectionTest)
+{
+    struct Traits : UnitTest::Mocks::Traits
+    {
+        using WaitHandleFactory = Policies::WaitHandleFactory;
+    };
+
+    auto name = detail::GenerateRandomString();
+
+    ChannelSettings<Traits> channelSettings;
+    channelSettings.SetAnonymousMemory(true);
+
+    std::unique_ptr<ServerAcceptor<int, int, Traits>::Connection> connection;
+    ServerAcceptor<int, int, Traits> acceptor{
+        name.c_str(), [&](auto&& futureConnection) { connection = futureConnection.get(); }, channelSettings };
+
+    auto clientAccessor = ConnectClient(name.c_str(), std::make_shared<ClientConnector<int, int, Traits>>(channelSettings), false);
+
+    BOOST_TEST(!!connection);
+    BOOST_TEST(!connection->IsClosed());
+    BOOST_TEST(connection->GetInputChannel().GetMemory()->GetName().empty());
+    BOOST_TEST(connection->GetOutputChannel().GetMemory()->GetName().empty());
+
+    const auto& clientConnection = clientAccessor()->GetConnection();
+    BOOST_TEST(!clientConnection.IsClosed());
+    BOOST_TEST(clientConnection.GetInputChannel().GetMemory()->GetName().empty());
+    BOOST_TEST(clientConnection.GetOutputChannel().GetMemory()->GetName().empty());
+}
+
+BOOST_AUTO_TEST_CASE(SlotConnectionTest)
+{
+    struct Traits : UnitTest::Mocks::Traits
+    {
+        using WaitHandleFactory = Policies::WaitHandleFactory;
+    };
+
+    auto name = detail::GenerateRandomString();
+
+    std::mutex lock;
+    std::condition_variable cvAccepted;
+    std::vector<std::unique_ptr<ServerAcceptor<int, int, Traits>::Connection>> connections;
+
+    ServerAcceptor<int, int, Traits> acceptor{
+        name.c_str(),
+        [&](auto&& futureConnection)
+        {
+            auto connection = futureConnection.get();
+            std::lock_guard<std::mutex> guard{ lock };
+            connections.push_back(std::move(connection));
+            cvAccepted.notify_one();
+        },
+        {},
+        0,
+        1 };
+
+    auto memory = std::make_shared<SharedMemory>(open_only, name.c_str());
+    auto& info = memory->Find<detail::AcceptorHostInfo>(unique_instance);
+    BOOST_TEST(info.m_slotCount == 1);
+
+    auto& slot = *info.m_slots;
+
+    ClientConnector<int, int, Traits> connector;
+
+    for (std::size_t i = 1; i <= 2; ++i)
+    {
+        while (detail::AcceptorSlot::GetState(slot.m_state.load()) != detail::AcceptorSlot::State::Ready)
+        {
+            std::this_thread::yield();  // Refilled in the background.
+        }
+
+        std::string acceptorChannelName{ slot.m_acceptorChannelName.c_str() };
+        std::string connectorChannelName{ slot.m_connectorChannelName.c_str() };
+
+        auto connection = connector.Connect(name.c_str()).get();
+        BOOST_TEST(!connection->IsClosed());
+        BOOST_TEST(connection->GetInputChannel().GetMemory()->GetName() == connectorChannelName);
+        BOOST_TEST(connection->GetOutputChannel().GetMemory()->GetName() == acceptorChannelName);
+
+        std::unique_lock<std::mutex> guard{ lock };
+        cvAccepted.wait(guard, [&] { return connections.size() == i; });
+
+        BOOST_TEST(!connections.back()->IsClosed());
+        BOOST_TEST(connections.back()->GetInputChannel().GetMemory()->GetName() == acceptorChannelName);
+        BOOST_TEST(connections.back()->GetOutputChannel().GetMemory()->GetName() == connectorChannelName);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SlotRecyclingTest)
+{
+    struct Traits : UnitTest::Mocks::Traits
+    {
+        using WaitHandleFactory = Policies::WaitHandleFactory;
+    };
+
+    auto name = detail::GenerateRandomString();
+
+    std::mutex lock;
+    std::condition_variable cvAccepted;
+    std::size_t connectionCount{ 0 };
+
+    ServerAcceptor<int, int, Traits> acceptor{
+        name.c_str(),
+        [&](auto&& futureConnection)
+        {
+            futureConnection.get();
+            std::lock_guard<std::mutex> guard{ lock };
+            ++connectionCount;
+            cvAccepted.notify_one();
+        },
+        {},
+        0,
+        1 };
+
+    auto memory = std::make_shared<SharedMemory>(open_only, name.c_str());
+    auto& slot = *memory->Find<detail::AcceptorHostInfo>(unique_instance).m_slots;
+
+    ClientConnector<int, int, Traits> connector;
+
+    const std::uint64_t unusableStates[] = {
+        detail::AcceptorSlot::MakeState(detail::AcceptorSlot::State::Claimed, 0xFFFFFFFC),    // Claimed by a process which does not exist.
+        detail::AcceptorSlot::MakeState(detail::AcceptorSlot::State::Failed) };
+    std::size_t i = 0;
+
+    for (auto unusableState : unusableStates)
+    {
+        std::string closeEventName{ slot.m_closeEventName.c_str() };
+
+        auto state = detail::AcceptorSlot::MakeState(detail::AcceptorSlot::State::Ready);
+        BOOST_TEST(slot.m_state.compare_exchange_strong(state, unusableState));
+
+        auto connection = connector.Connect(name.c_str()).get();   // Falls back to the ping channel.
+        BOOST_TEST(!connection->IsClosed());
+
+        ++i;
+
+        {
+            std::unique_lock<std::mutex> guard{ lock };
+            cvAccepted.wait(guard, [&] { return connectionCount == i; });
+        }
+
+        BOOST_TEST((detail::AcceptorSlot::GetState(slot.m_state.load()) == detail::AcceptorSlot::State::Ready));
+        BOOST_TEST(slot.m_closeEventName.c_str() != closeEventName);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(AsyncClientConnectionTest)
 {
     auto name = detail::GenerateRandomString();
@@ -118,6 +273,89 @@ BOOST_AUTO_TEST_CASE(ClientReconnectionTest)
     }
 }
 
+BOOST_AUTO_TEST_CASE(ConcurrentReconnectionStressTest)
+{
+    using Traits = DefaultTraits;
+
+    constexpr std::size_t ClientCount = 32;
+    constexpr auto RestartCount = 3;
+
+    auto name = detail::GenerateRandomString();
+
+    std::atomic_size_t errorCount{ 0 }, maxAttempt{ 0 };
+
+    auto errorHandler = [&](std::exception_ptr, std::size_t attempt)
+    {
+        ++errorCount;
+
+        for (auto current = maxAttempt.load(); current < attempt && !maxAttempt.compare_exchange_weak(current, attempt); )
+        {}
+    };
+
+    auto connector = std::make_shared<ClientConnector<int, int, Traits>>();
+    Policies::TimeoutFactory timeoutFactory{
+        {}, {}, Policies::ReconnectPolicy{ std::chrono::milliseconds{ 1 }, std::chrono::milliseconds{ 20 } } };
+
+    std::vector<std::function<std::shared_ptr<Client<int, int, Traits>>()>> clientAccessors;
+
+    for (std::size_t i = 0; i != ClientCount; ++i)
+    {
+        clientAccessors.push_back(
+            ConnectClient(name.c_str(), connector, true, timeoutFactory, errorHandler));
+    }
+
+    auto isConnected = [](auto& clientAccessor)
+    {
+        try
+        {
+            return !clientAccessor()->GetConnection().IsClosed();
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
+    };
+
+    auto waitConnected = [&]
+    {
+        for (auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 30 }; std::chrono::steady_clock::now() < deadline; )
+        {
+            if (std::all_of(clientAccessors.begin(), clientAccessors.end(), isConnected))
+            {
+                return true;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+        }
+
+        return false;
+    };
+
+    for (auto i = 0; i < RestartCount; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 100 });     // Lets every client fail a few times.
+
+        BOOST_TEST(std::none_of(clientAccessors.begin(), clientAccessors.end(), isConnected));
+        BOOST_TEST(maxAttempt > 1);
+
+        auto serversAccessor = AcceptServers<int, int, Traits>(
+            name.c_str(), [](auto&&) { return [](int x, auto&& callback) { callback(x); }; });
+
+        BOOST_TEST(waitConnected());
+
+        for (auto& clientAccessor : clientAccessors)
+        {
+            BOOST_TEST((*clientAccessor())(i).get() == i);
+        }
+
+        auto count = errorCount.load();
+        maxAttempt = 0;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+        BOOST_TEST(errorCount == count);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(ConnectingClientDestructionTest)
 {
     auto name = detail::GenerateRandomString();
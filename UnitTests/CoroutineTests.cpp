@@ -0,0 +1,218 @@
+#include "stdafx.h"
+
+#ifndef __cpp_impl_coroutine
+#error Coroutine tests require C++20, see the CoroutineTests.cpp settings in UnitTests.vcxproj.
+#endif
+
+#include "IPC/Coroutine.h"
+#include "IPC/Accept.h"
+#include "IPC/Client.h"
+#include "IPC/detail/RandomString.h"
+#include "TraitsMock.h"
+#include "AllocationCounter.h"
+#include <memory>
+#include <vector>
+#include <future>
+#include <thread>
+#include <functional>
+#include <string>
+#include <stdexcept>
+
+using namespace IPC;
+
+
+BOOST_AUTO_TEST_SUITE(CoroutineTests)
+
+template <typename T>
+detail::DetachedTask Complete(Task<T> task, std::shared_ptr<std::promise<T>> result)
+{
+    try
+    {
+        result->set_value(co_await std::move(task));
+    }
+    catch (...)
+    {
+        result->set_exception(std::current_exception());
+    }
+}
+
+template <typename T>
+std::future<T> Start(Task<T> task)
+{
+    auto result = std::make_shared<std::promise<T>>();
+    auto future = result->get_future();
+
+    Complete(std::move(task), result);
+
+    return future;
+}
+
+Task<int> Increment(int x)
+{
+    co_return x + 1;
+}
+
+Task<int> Await(Completion<int> completion)
+{
+    co_return co_await std::move(completion);
+}
+
+struct QueueExecutor
+{
+    template <typename Function>
+    void operator()(Function&& func) const
+    {
+        m_queue->push_back(std::forward<Function>(func));
+    }
+
+    std::vector<std::function<void()>>* m_queue;
+};
+
+BOOST_AUTO_TEST_CASE(TaskTest)
+{
+    auto task = []() -> Task<int>
+    {
+        auto x = co_await Increment(1);
+        co_return co_await Increment(x);
+    };
+
+    BOOST_TEST(Start(task()).get() == 3);
+}
+
+BOOST_AUTO_TEST_CASE(TaskExceptionTest)
+{
+    auto task = []() -> Task<int>
+    {
+        co_await Increment(1);
+        throw std::runtime_error{ "Failure." };
+    };
+
+    BOOST_CHECK_THROW(Start(task()).get(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(CompletionAwaitTest)
+{
+    {
+        auto completion = detail::MakeCompletion<int>();
+        auto result = Start(Await(std::move(completion.first)));
+
+        BOOST_TEST((result.wait_for(std::chrono::milliseconds{ 1 }) == std::future_status::timeout));
+
+        std::thread producer{ [source = std::move(completion.second)]() mutable { source(123); } };
+        BOOST_TEST(result.get() == 123);
+        producer.join();
+    }
+    {
+        auto completion = detail::MakeCompletion<int>();
+        completion.second(456);
+
+        BOOST_TEST(Start(Await(std::move(completion.first))).get() == 456);
+    }
+    {
+        auto completion = detail::MakeCompletion<int>();
+        auto result = Start(Await(std::move(completion.first)));
+
+        completion.second = detail::CompletionSource<int>{ {} };
+        BOOST_CHECK_THROW(result.get(), std::future_error);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ExecutorTest)
+{
+    std::vector<std::function<void()>> queue;
+
+    auto completion = detail::MakeCompletion<int>();
+
+    auto result = Start(
+        [](Completion<int> completion, QueueExecutor executor) -> Task<int>
+        {
+            co_return co_await ResumeOn(std::move(completion), executor);
+        }(std::move(completion.first), QueueExecutor{ &queue }));
+
+    completion.second(1);
+
+    BOOST_TEST(queue.size() == 1);
+    BOOST_TEST((result.wait_for(std::chrono::milliseconds{ 1 }) == std::future_status::timeout));
+
+    queue.front()();
+    BOOST_TEST(result.get() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(CoroutineHandlerTest)
+{
+    auto handler = MakeCoroutineHandler([](int x) -> Task<int> { co_return co_await Increment(x); });
+
+    int response = 0;
+    handler(1, detail::Callback<void(int)>{ [&](int y) { response = y; } });
+    BOOST_TEST(response == 2);
+
+    auto failingHandler = MakeCoroutineHandler([](int) -> Task<int> { throw std::runtime_error{ "Failure." }; co_return 0; });
+
+    auto context = std::make_shared<int>();
+    bool invoked = false;
+    failingHandler(1, detail::Callback<void(int)>{ [&, context](int) { invoked = true; } });
+    BOOST_TEST(!invoked);
+    BOOST_TEST(context.unique());
+
+    auto voidHandler = MakeCoroutineHandler([&](int x) -> Task<> { response = x; co_return; });
+    voidHandler(3);
+    BOOST_TEST(response == 3);
+}
+
+BOOST_AUTO_TEST_CASE(FramePoolTest)
+{
+    auto handler = MakeCoroutineHandler([](int x) -> Task<int> { co_return co_await Increment(x); });
+
+    int response = 0;
+
+    auto invoke = [&]
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            handler(i, detail::Callback<void(int)>{ [&response](int y) { response = y; } });
+        }
+    };
+
+    invoke();
+
+    std::size_t allocationCount;
+    {
+        UnitTest::AllocationCounter allocations;
+        invoke();
+        allocationCount = allocations.GetCount();
+    }
+
+    BOOST_TEST(allocationCount == 0);
+    BOOST_TEST(response == 100);
+}
+
+BOOST_AUTO_TEST_CASE(ConnectAndCallTest)
+{
+    using Traits = UnitTest::Mocks::NullTimeoutTraits;
+
+    auto name = detail::GenerateRandomString();
+
+    auto serversAccessor = AcceptServers<int, int, Traits>(
+        name.c_str(), [](auto&&...) { return MakeCoroutineHandler([](int x) -> Task<int> { co_return x * 2; }); });
+
+    ClientConnector<int, int, Traits> connector;
+
+    auto connection = Start(
+        [](ClientConnector<int, int, Traits>& connector, std::string name) -> Task<std::unique_ptr<ClientConnector<int, int, Traits>::Connection>>
+        {
+            co_return co_await AsyncConnect(connector, name.c_str());
+        }(connector, name)).get();
+
+    Client<int, int, Traits> client{ std::move(connection), [] {} };
+
+    auto result = Start(
+        [](Client<int, int, Traits>& client) -> Task<int>
+        {
+            auto x = co_await client.Call(10);
+            co_return co_await client.Call(x);
+        }(client));
+
+    BOOST_TEST(result.get() == 40);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
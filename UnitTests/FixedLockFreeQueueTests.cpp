@@ -4,8 +4,11 @@
 #include "IPC/detail/LockFree/FixedQueue.h"
 #include <memory>
 #include <vector>
+#include <numeric>
+#include <iterator>
 #include <thread>
 #include <atomic>
+#include <stdexcept>
 
 using namespace IPC;
 
@@ -146,6 +149,89 @@ BOOST_AUTO_TEST_CASE(ExceptionSafetyTest)
     BOOST_TEST(queue.IsEmpty());
 }
 
+BOOST_AUTO_TEST_CASE(BulkPushTest)
+{
+    constexpr std::size_t N = 8;
+    {
+        detail::LockFree::FixedQueue<std::size_t, N> queue;
+
+        std::vector<std::size_t> values(N + 2);
+        std::iota(values.begin(), values.end(), 1);
+
+        BOOST_TEST(queue.Push(values.begin(), values.end()) == N);
+        BOOST_TEST(queue.Push(values.begin(), values.end()) == 0);
+
+        std::size_t sum{ 0 };
+        BOOST_TEST(queue.ConsumeAll([&](std::size_t&& x) { sum += x; }) == N);
+        BOOST_TEST(sum == (N * (N + 1)) / 2);
+    }
+    {
+        detail::LockFree::FixedQueue<std::unique_ptr<std::size_t>, N> queue;
+        BOOST_TEST(queue.Push(std::make_unique<std::size_t>(0)));
+
+        std::vector<std::unique_ptr<std::size_t>> values;
+        for (std::size_t i = 1; i <= N; ++i)
+        {
+            values.push_back(std::make_unique<std::size_t>(i));
+        }
+
+        BOOST_TEST(queue.Push(std::make_move_iterator(values.begin()), std::make_move_iterator(values.begin())) == 0);
+        BOOST_TEST(queue.Push(std::make_move_iterator(values.begin()), std::make_move_iterator(values.end())) == N - 1);
+        BOOST_TEST(!values.front());
+        BOOST_TEST(!!values.back());    // Rejected elements are not moved out.
+
+        std::size_t expected{ 0 };
+        BOOST_TEST(queue.ConsumeAll([&](std::unique_ptr<std::size_t>&& x) { BOOST_TEST(*x == expected++); }) == N);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(BulkPushExceptionSafetyTest)
+{
+    struct X
+    {
+        explicit X(std::shared_ptr<int> value, bool doThrow = false)
+            : m_value{ std::move(value) },
+              m_throw{ doThrow }
+        {}
+
+        X(const X& other)
+            : m_value{ other.m_value },
+              m_throw{ other.m_throw }
+        {
+            if (m_throw)
+            {
+                throw std::runtime_error{ "Copy failed." };
+            }
+        }
+
+        X& operator=(const X& other) = default;
+
+        std::shared_ptr<int> m_value;
+        bool m_throw;
+    };
+
+    auto value = std::make_shared<int>();
+
+    std::vector<X> values;
+    values.reserve(4);
+    for (int i = 0; i < 4; ++i)
+    {
+        values.emplace_back(value, i == 2);
+    }
+
+    detail::LockFree::FixedQueue<X, 8> queue;
+
+    BOOST_CHECK_THROW(queue.Push(values.begin(), values.end()), std::runtime_error);
+    BOOST_TEST(value.use_count() == 5);     // Elements constructed before the failure are destroyed.
+    BOOST_TEST(queue.IsEmpty());
+    BOOST_TEST(!queue.Pop());
+
+    values[2].m_throw = false;
+    BOOST_TEST(queue.Push(values.begin(), values.end()) == 4);
+    BOOST_TEST(queue.ConsumeAll([](X&&) {}) == 4);
+    BOOST_TEST(value.use_count() == 5);
+}
+
 BOOST_AUTO_TEST_CASE(StressTest)
 {
     constexpr std::size_t N = 100;
@@ -202,6 +288,54 @@ BOOST_AUTO_TEST_CASE(StressTest)
     BOOST_TEST(sum == (N * (N + 1)) / 2);
 }
 
+BOOST_AUTO_TEST_CASE(MultiProducerStressTest)
+{
+    constexpr int N = 10000;
+    constexpr std::size_t c_maxProducerCount = 16;
+
+    for (std::size_t producerCount = 1; producerCount <= c_maxProducerCount; producerCount *= 2)
+    {
+        detail::LockFree::FixedQueue<std::unique_ptr<int>, 64> queue;
+
+        std::atomic_int value{ 0 };
+        long long sum{ 0 };
+        int count{ 0 };
+
+        std::vector<std::thread> producers;
+        for (std::size_t i = 0; i < producerCount; ++i)
+        {
+            producers.emplace_back(
+                [&]
+                {
+                    for (int x; (x = ++value) <= N; )
+                    {
+                        auto item = std::make_unique<int>(x);
+                        while (!queue.Push(std::move(item)))
+                        {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+        }
+
+        while (count != N)
+        {
+            if (!queue.ConsumeAll([&](std::unique_ptr<int>&& x) { ++count; sum += *x; }))
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        for (auto& producer : producers)
+        {
+            producer.join();
+        }
+
+        BOOST_TEST(queue.IsEmpty());
+        BOOST_TEST(sum == (static_cast<long long>(N) * (N + 1)) / 2);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 #pragma warning(pop)
@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "IPC/detail/LockFree/IndexedObjectPool.h"
+#include <vector>
 
 using namespace IPC;
 
@@ -77,4 +78,65 @@ BOOST_AUTO_TEST_CASE(BasicTest)
     }
 }
 
+BOOST_AUTO_TEST_CASE(ManyBucketsTest)
+{
+    constexpr std::uint32_t N = 1000;
+
+    detail::LockFree::IndexedObjectPool<std::uint32_t, std::allocator<void>, 2> pool{ {} };
+
+    std::vector<std::uint32_t*> items;
+
+    for (std::uint32_t i = 0; i < N; ++i)
+    {
+        auto item = pool.Take();
+        BOOST_TEST(item.second == i);
+        BOOST_TEST(item.first == i);
+        items.push_back(&item.first);
+    }
+
+    BOOST_TEST(!pool.Return(N));
+    BOOST_TEST(!pool.Return(N + 2));
+
+    for (std::uint32_t i = N; i-- > 0; )
+    {
+        BOOST_TEST(pool.Return(i, [&](auto& x) { BOOST_TEST(&x == items[i]); }));
+        BOOST_TEST(!pool.Return(i));
+    }
+
+    for (std::uint32_t i = 0; i < N; ++i)
+    {
+        auto item = pool.Take();
+        BOOST_TEST(&item.first == items[item.second]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(GenerationTest)
+{
+    constexpr std::uint32_t SlotMask = (1u << 28) - 1;
+
+    detail::LockFree::IndexedObjectPool<std::uint32_t, std::allocator<void>, 2, 4> pool{ {} };
+
+    auto first = pool.Take();
+    BOOST_TEST(first.second == 0u);
+    BOOST_TEST(pool.Return(first.second));
+
+    auto index = first.second;
+
+    for (std::uint32_t i = 1; i <= 16; ++i)
+    {
+        auto item = pool.Take();
+        BOOST_TEST(&item.first == &first.first);
+        BOOST_TEST((item.second & SlotMask) == 0u);
+        BOOST_TEST((item.second >> 28) == i % 16);
+
+        BOOST_TEST(!pool.Return(index));
+        BOOST_TEST(pool.Return(item.second));
+        BOOST_TEST(!pool.Return(item.second));
+
+        index = item.second;
+    }
+
+    BOOST_TEST(index == first.second);  // The generation wraps around.
+}
+
 BOOST_AUTO_TEST_SUITE_END()
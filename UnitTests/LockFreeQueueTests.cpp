@@ -1,11 +1,58 @@
 #include "stdafx.h"
 #include "IPC/detail/LockFree/Queue.h"
+#include <vector>
+#include <numeric>
+#include <memory>
+#include <stdexcept>
+#include <future>
+#include <thread>
+#include <functional>
 
 using namespace IPC;
 
 
 BOOST_AUTO_TEST_SUITE(LockFreeQueueTests)
 
+template <typename T>
+class CountingAllocator : public std::allocator<T>
+{
+public:
+    template <typename U>
+    struct rebind
+    {
+        using other = CountingAllocator<U>;
+    };
+
+    explicit CountingAllocator(std::shared_ptr<std::size_t> count)
+        : m_count{ std::move(count) }
+    {}
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& other)
+        : m_count{ other.GetCount() }
+    {}
+
+    T* allocate(std::size_t n)
+    {
+        ++*m_count;
+        return std::allocator<T>::allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+        --*m_count;
+        std::allocator<T>::deallocate(p, n);
+    }
+
+    const std::shared_ptr<std::size_t>& GetCount() const
+    {
+        return m_count;
+    }
+
+private:
+    std::shared_ptr<std::size_t> m_count;
+};
+
 static_assert(!std::is_copy_constructible<detail::LockFree::Queue<int, std::allocator<void>>>::value, "LockFree::Queue should not be copy constructible.");
 static_assert(!std::is_copy_assignable<detail::LockFree::Queue<int, std::allocator<void>>>::value, "LockFree::Queue should not be copy assignable.");
 static_assert(!std::is_move_constructible<detail::LockFree::Queue<int, std::allocator<void>>>::value, "LockFree::Queue should not be move constructible.");
@@ -34,4 +81,291 @@ BOOST_AUTO_TEST_CASE(BasicTest)
     BOOST_TEST(sum == N * (N + 1)/2);
 }
 
+BOOST_AUTO_TEST_CASE(BulkPushTest)
+{
+    constexpr int N = 10;
+    detail::LockFree::Queue<int, std::allocator<void>, 4> queue{ {} };
+
+    BOOST_TEST(queue.Push(N + 1));
+
+    std::vector<int> values(N);
+    std::iota(values.begin(), values.end(), 1);
+
+    BOOST_TEST(queue.Push(values.begin(), values.end()) == N);
+
+    int sum{ 0 };
+    BOOST_TEST(queue.ConsumeAll([&](int x) { sum += x; }) == N + 1);
+
+    BOOST_TEST(sum == (N + 1) * (N + 2)/2);
+    BOOST_TEST(queue.IsEmpty());
+}
+
+BOOST_AUTO_TEST_CASE(BulkPushExceptionSafetyTest)
+{
+    struct X
+    {
+        explicit X(std::shared_ptr<int> value, bool doThrow = false)
+            : m_value{ std::move(value) },
+              m_throw{ doThrow }
+        {}
+
+        X(const X& other)
+            : m_value{ other.m_value },
+              m_throw{ other.m_throw }
+        {
+            if (m_throw)
+            {
+                throw std::runtime_error{ "Copy failed." };
+            }
+        }
+
+        X& operator=(const X& other) = default;
+
+        std::shared_ptr<int> m_value;
+        bool m_throw;
+    };
+
+    auto value = std::make_shared<int>();
+
+    std::vector<X> values;
+    values.reserve(6);
+    for (int i = 0; i < 6; ++i)
+    {
+        values.emplace_back(value, i == 5);
+    }
+
+    detail::LockFree::Queue<X, std::allocator<void>, 4> queue{ {} };
+
+    BOOST_TEST(queue.Push(values.begin(), values.end()) == 4);  // The first bucket is already visible to readers.
+    BOOST_CHECK_THROW(queue.Push(values.begin() + 4, values.end()), std::runtime_error);
+    BOOST_TEST(value.use_count() == 11);
+
+    BOOST_TEST(queue.ConsumeAll([](X&&) {}) == 4);
+    BOOST_TEST(queue.IsEmpty());
+    BOOST_TEST(value.use_count() == 7);
+}
+
+BOOST_AUTO_TEST_CASE(BucketReclamationTest)
+{
+    constexpr std::size_t BucketSize = 4;
+    constexpr std::size_t BucketCount = 8;
+
+    auto allocations = std::make_shared<std::size_t>(0);
+    detail::LockFree::Queue<std::size_t, CountingAllocator<void>, BucketSize> queue{ CountingAllocator<void>{ allocations }, true };
+
+    for (std::size_t i = 0; i < BucketSize * BucketCount; ++i)
+    {
+        BOOST_TEST(queue.Push(i));
+    }
+
+    BOOST_TEST(*allocations == BucketCount - 1);
+
+    // Every drain releases at most half of the idle buckets.
+    BOOST_TEST(queue.ConsumeAll([](std::size_t) {}) == BucketSize * BucketCount);
+    BOOST_TEST(*allocations == 3);
+    BOOST_TEST(queue.ConsumeAll([](std::size_t) {}) == 0);
+    BOOST_TEST(*allocations == 1);
+    BOOST_TEST(queue.ConsumeAll([](std::size_t) {}) == 0);
+    BOOST_TEST(*allocations == 0);
+
+    for (std::size_t i = 0; i < 2 * BucketSize; ++i)
+    {
+        BOOST_TEST(queue.Push(i));
+    }
+
+    BOOST_TEST(*allocations == 1);
+
+    std::size_t sum{ 0 };
+    BOOST_TEST(queue.ConsumeAll([&](std::size_t x) { sum += x; }) == 2 * BucketSize);
+    BOOST_TEST(sum == BucketSize * (2 * BucketSize - 1));
+    BOOST_TEST(*allocations == 0);
+    BOOST_TEST(queue.IsEmpty());
+}
+
+BOOST_AUTO_TEST_CASE(BucketsKeptByDefaultTest)
+{
+    constexpr std::size_t BucketSize = 4;
+    constexpr std::size_t BucketCount = 8;
+
+    auto allocations = std::make_shared<std::size_t>(0);
+    detail::LockFree::Queue<std::size_t, CountingAllocator<void>, BucketSize> queue{ CountingAllocator<void>{ allocations } };
+
+    for (std::size_t i = 0; i < BucketSize * BucketCount; ++i)
+    {
+        BOOST_TEST(queue.Push(i));
+    }
+
+    BOOST_TEST(queue.ConsumeAll([](std::size_t) {}) == BucketSize * BucketCount);
+    BOOST_TEST(queue.ConsumeAll([](std::size_t) {}) == 0);
+    BOOST_TEST(*allocations == BucketCount - 1);
+}
+
+BOOST_AUTO_TEST_CASE(TrimDoesNotWaitForReadersTest)
+{
+    auto allocations = std::make_shared<std::size_t>(0);
+    detail::LockFree::ContainerList<int, CountingAllocator<void>, true> list{ CountingAllocator<void>{ allocations } };
+    list.EnableReclamation();
+
+    auto fill = [](int& x) { return x == 0 && (x = 1) != 0; };
+    auto isEmpty = [](int x) { return x == 0; };
+
+    list.Apply(fill);
+    list.Apply(fill);
+    BOOST_TEST(*allocations == 1);
+
+    list.TryApply([](int& x) { x = 0; return false; });
+
+    std::promise<void> entered, leave;
+
+    std::thread reader{
+        [&]
+        {
+            list.TryApply([&](int&) { entered.set_value(); leave.get_future().wait(); return true; });
+        } };
+
+    entered.get_future().wait();
+
+    BOOST_TEST(!list.Trim(isEmpty));    // Returns right away and leaves the node detached.
+    BOOST_TEST(*allocations == 1);
+
+    leave.set_value();
+    reader.join();
+
+    BOOST_TEST(list.Trim(isEmpty));
+    BOOST_TEST(*allocations == 0);
+
+    list.Apply(fill);
+    list.Apply(fill);
+    BOOST_TEST(*allocations == 1);
+}
+
+BOOST_AUTO_TEST_CASE(TrimAttachesBackNodesFilledByPreemptedWriterTest)
+{
+    auto allocations = std::make_shared<std::size_t>(0);
+    detail::LockFree::ContainerList<int, CountingAllocator<void>, true> list{ CountingAllocator<void>{ allocations } };
+    list.EnableReclamation();
+
+    auto fill = [](int& x) { return x == 0 && (x = 1) != 0; };
+    auto isEmpty = [](int x) { return x == 0; };
+
+    list.Apply(fill);
+    list.Apply(fill);
+    list.TryApply([](int& x) { x = 0; return false; });
+
+    std::promise<void> readerEntered, readerLeave, writerEntered, writerResume;
+
+    std::thread reader{
+        [&]
+        {
+            list.TryApply([&](int&) { readerEntered.set_value(); readerLeave.get_future().wait(); return true; });
+        } };
+
+    std::thread writer{
+        [&]
+        {
+            std::size_t index{ 0 };
+
+            list.Apply(
+                [&](int& x)
+                {
+                    if (index++ == 0)
+                    {
+                        return false;   // Pass the first node as if it was full.
+                    }
+
+                    writerEntered.set_value();
+                    writerResume.get_future().wait();   // Preempted between the traversal and the push.
+
+                    x = 1;
+                    return true;
+                });
+        } };
+
+    readerEntered.get_future().wait();
+    writerEntered.get_future().wait();
+
+    BOOST_TEST(!list.Trim(isEmpty));    // Detaches the empty second node.
+    BOOST_TEST(list.IsTrimPending());
+
+    writerResume.set_value();
+    writer.join();
+
+    BOOST_TEST(!list.Trim(isEmpty));    // Readers are still inside, but the node is filled so it is attached back.
+    BOOST_TEST(!list.IsTrimPending());
+
+    int sum{ 0 };
+    list.TryApply([&](int x) { sum += x; return false; });
+    BOOST_TEST(sum == 1);
+
+    readerLeave.set_value();
+    reader.join();
+
+    BOOST_TEST(*allocations == 1);
+}
+
+BOOST_AUTO_TEST_CASE(PendingTrimFinishedWithSingleVisibleBucketTest)
+{
+    struct X
+    {
+        explicit X(const std::function<void()>* onMove = nullptr)
+            : m_onMove{ onMove }
+        {}
+
+        X(X&& other)
+            : m_onMove{ other.m_onMove }
+        {
+            if (m_onMove)
+            {
+                (*m_onMove)();
+            }
+        }
+
+        X& operator=(X&& other)
+        {
+            m_onMove = other.m_onMove;
+            return *this;
+        }
+
+        const std::function<void()>* m_onMove;
+    };
+
+    auto allocations = std::make_shared<std::size_t>(0);
+    detail::LockFree::Queue<X, CountingAllocator<void>, 2> queue{ CountingAllocator<void>{ allocations }, true };
+
+    std::promise<void> entered, leave;
+    bool armed{ false };
+
+    std::function<void()> onMove = [&]
+    {
+        if (armed)
+        {
+            armed = false;
+            entered.set_value();
+            leave.get_future().wait();
+        }
+    };
+
+    for (auto i = 0; i < 4; ++i)
+    {
+        BOOST_TEST(queue.Push(X{ &onMove }));
+    }
+
+    BOOST_TEST(*allocations == 1);
+
+    armed = true;
+
+    std::thread reader{ [&] { queue.Pop(); } };     // Stays inside the queue while moving the popped element out.
+
+    entered.get_future().wait();
+
+    BOOST_TEST(queue.ConsumeAll([](X&&) {}) == 3);  // Detaches the drained second bucket but cannot release it yet.
+    BOOST_TEST(*allocations == 1);
+
+    leave.set_value();
+    reader.join();
+
+    BOOST_TEST(queue.ConsumeAll([](X&&) {}) == 0);  // Only the first bucket is visible, but the pending trim is finished.
+    BOOST_TEST(*allocations == 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
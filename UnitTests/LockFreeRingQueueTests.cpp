@@ -0,0 +1,215 @@
+#include "stdafx.h"
+#pragma warning(push)
+#pragma warning(disable : 4702) // Unreachable code.
+#include "IPC/detail/LockFree/RingQueue.h"
+#include <memory>
+#include <vector>
+#include <iterator>
+#include <thread>
+#include <atomic>
+#include <stdexcept>
+
+using namespace IPC;
+
+
+BOOST_AUTO_TEST_SUITE(LockFreeRingQueueTests)
+
+static_assert(!std::is_copy_constructible<detail::LockFree::RingQueue<int, std::allocator<void>, 1>>::value, "LockFree::RingQueue should not be copy constructible.");
+static_assert(!std::is_copy_assignable<detail::LockFree::RingQueue<int, std::allocator<void>, 1>>::value, "LockFree::RingQueue should not be copy assignable.");
+static_assert(!std::is_move_constructible<detail::LockFree::RingQueue<int, std::allocator<void>, 1>>::value, "LockFree::RingQueue should not be move constructible.");
+static_assert(!std::is_move_assignable<detail::LockFree::RingQueue<int, std::allocator<void>, 1>>::value, "LockFree::RingQueue should not be move assignable.");
+
+BOOST_AUTO_TEST_CASE(TrivialTypeTest)
+{
+    constexpr std::size_t N = 16;
+
+    detail::LockFree::RingQueue<std::size_t, std::allocator<void>, N> queue;
+    BOOST_TEST(queue.IsEmpty());
+
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        BOOST_TEST(queue.Push(i + 1));
+    }
+
+    BOOST_TEST(!queue.IsEmpty());
+    BOOST_TEST(!queue.Push(N));
+
+    auto value = queue.Pop();
+    BOOST_TEST(!!value);
+    BOOST_TEST(!queue.IsEmpty());
+    std::size_t sum = *value;
+
+    BOOST_TEST(queue.Push(N + 1));
+    sum -= N + 1;
+
+    BOOST_TEST(queue.ConsumeAll([&](std::size_t&& x) { sum += x; }) == N);
+    BOOST_TEST(queue.IsEmpty());
+    BOOST_TEST(!queue.Pop());
+
+    BOOST_TEST(sum == (N * (N + 1)) / 2);
+}
+
+BOOST_AUTO_TEST_CASE(MoveOnlyTypeTest)
+{
+    detail::LockFree::RingQueue<std::unique_ptr<int>, std::allocator<void>, 1> queue;
+    BOOST_TEST(queue.IsEmpty());
+
+    constexpr int value = 123;
+    BOOST_TEST(queue.Push(std::make_unique<int>(value)));
+    BOOST_TEST(!queue.IsEmpty());
+
+    auto x = queue.Pop();
+    BOOST_TEST(!!x);
+    BOOST_TEST(queue.IsEmpty());
+    BOOST_TEST(**x == value);
+}
+
+BOOST_AUTO_TEST_CASE(ComplexTypeDestructionTest)
+{
+    auto value = std::make_shared<int>();
+    {
+        detail::LockFree::RingQueue<std::shared_ptr<int>, std::allocator<void>, 4> queue;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            BOOST_TEST(queue.Push(value));
+        }
+
+        BOOST_TEST(!queue.Push(value));
+        BOOST_TEST(value.use_count() == 5);
+
+        BOOST_TEST(!!queue.Pop());
+        BOOST_TEST(value.use_count() == 4);
+    }
+    BOOST_TEST(value.unique());
+}
+
+BOOST_AUTO_TEST_CASE(ExceptionSafetyTest)
+{
+    detail::LockFree::RingQueue<std::shared_ptr<int>, std::allocator<void>, 2> queue;
+
+    auto value = std::make_shared<int>();
+    BOOST_TEST(queue.Push(value));
+    BOOST_TEST(queue.Push(value));
+
+    BOOST_CHECK_THROW(queue.ConsumeAll([](std::shared_ptr<int>&&) { throw std::exception{}; }), std::exception);
+    BOOST_TEST(!queue.IsEmpty());
+    BOOST_TEST(value.use_count() == 2);
+
+    BOOST_TEST(queue.ConsumeAll([](std::shared_ptr<int>&&) {}) == 1);
+    BOOST_TEST(queue.IsEmpty());
+    BOOST_TEST(value.unique());
+}
+
+BOOST_AUTO_TEST_CASE(BulkPushTest)
+{
+    constexpr std::size_t N = 8;
+
+    detail::LockFree::RingQueue<std::unique_ptr<std::size_t>, std::allocator<void>, N> queue;
+    BOOST_TEST(queue.Push(std::make_unique<std::size_t>(0)));
+    BOOST_TEST(!!queue.Pop());
+    BOOST_TEST(queue.Push(std::make_unique<std::size_t>(0)));   // Make the range wrap around.
+
+    std::vector<std::unique_ptr<std::size_t>> values;
+    for (std::size_t i = 1; i <= N; ++i)
+    {
+        values.push_back(std::make_unique<std::size_t>(i));
+    }
+
+    BOOST_TEST(queue.Push(std::make_move_iterator(values.begin()), std::make_move_iterator(values.end())) == N - 1);
+    BOOST_TEST(!values.front());
+    BOOST_TEST(!!values.back());    // Rejected elements are not moved out.
+
+    std::size_t expected{ 0 };
+    BOOST_TEST(queue.ConsumeAll([&](std::unique_ptr<std::size_t>&& x) { BOOST_TEST(*x == expected++); }) == N);
+
+    BOOST_TEST(queue.Push(std::make_move_iterator(values.end() - 1), std::make_move_iterator(values.end())) == 1);
+    BOOST_TEST(queue.ConsumeAll([&](std::unique_ptr<std::size_t>&& x) { BOOST_TEST(*x == N); }) == 1);
+}
+
+BOOST_AUTO_TEST_CASE(BulkPushExceptionSafetyTest)
+{
+    struct X
+    {
+        explicit X(std::shared_ptr<int> value, bool doThrow = false)
+            : m_value{ std::move(value) },
+              m_throw{ doThrow }
+        {}
+
+        X(const X& other)
+            : m_value{ other.m_value },
+              m_throw{ other.m_throw }
+        {
+            if (m_throw)
+            {
+                throw std::runtime_error{ "Copy failed." };
+            }
+        }
+
+        X& operator=(const X& other) = default;
+
+        std::shared_ptr<int> m_value;
+        bool m_throw;
+    };
+
+    auto value = std::make_shared<int>();
+
+    std::vector<X> values;
+    values.reserve(4);
+    for (int i = 0; i < 4; ++i)
+    {
+        values.emplace_back(value, i == 2);
+    }
+
+    detail::LockFree::RingQueue<X, std::allocator<void>, 8> queue;
+
+    BOOST_CHECK_THROW(queue.Push(values.begin(), values.end()), std::runtime_error);
+    BOOST_TEST(value.use_count() == 5);     // Elements constructed before the failure are destroyed.
+    BOOST_TEST(queue.IsEmpty());
+
+    values[2].m_throw = false;
+    BOOST_TEST(queue.Push(values.begin(), values.end()) == 4);
+    BOOST_TEST(queue.ConsumeAll([](X&&) {}) == 4);
+    BOOST_TEST(value.use_count() == 5);
+}
+
+BOOST_AUTO_TEST_CASE(StressTest)
+{
+    constexpr int N = 100000;
+
+    detail::LockFree::RingQueue<std::unique_ptr<int>, std::allocator<void>, 64> queue;
+
+    long long sum{ 0 };
+    int expected{ 1 };
+    bool ordered{ true };
+
+    std::thread consumer{
+        [&]
+        {
+            while (expected <= N)
+            {
+                if (!queue.ConsumeAll([&](std::unique_ptr<int>&& x) { ordered &= (*x == expected++); sum += *x; }))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        } };
+
+    for (int i = 1; i <= N; ++i)
+    {
+        while (!queue.Push(std::make_unique<int>(i)))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    consumer.join();
+
+    BOOST_TEST(queue.IsEmpty());
+    BOOST_TEST(ordered);
+    BOOST_TEST(sum == (static_cast<long long>(N) * (N + 1)) / 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#pragma warning(pop)
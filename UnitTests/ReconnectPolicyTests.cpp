@@ -0,0 +1,66 @@
+#include "stdafx.h"
+#include "IPC/Policies/ReconnectPolicy.h"
+#include "IPC/Policies/TimeoutFactory.h"
+#include <chrono>
+#include <set>
+
+using namespace IPC;
+
+
+BOOST_AUTO_TEST_SUITE(ReconnectPolicyTests)
+
+BOOST_AUTO_TEST_CASE(DefaultTimeoutTest)
+{
+    Policies::ReconnectPolicy policy;
+
+    BOOST_TEST(policy(0).count() == 0);
+    BOOST_TEST(policy(10).count() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(ExponentialBackoffTest)
+{
+    Policies::ReconnectPolicy policy{ std::chrono::milliseconds{ 10 }, std::chrono::milliseconds{ 50 }, 2.0, 0.0 };
+
+    BOOST_TEST(policy(0).count() == 10);
+    BOOST_TEST(policy(1).count() == 20);
+    BOOST_TEST(policy(2).count() == 40);
+    BOOST_TEST(policy(3).count() == 50);
+    BOOST_TEST(policy(1000).count() == 50);
+}
+
+BOOST_AUTO_TEST_CASE(JitterTest)
+{
+    Policies::ReconnectPolicy policy{ std::chrono::milliseconds{ 1000 }, std::chrono::milliseconds{ 1000 }, 2.0, 0.5 };
+
+    std::set<std::chrono::milliseconds::rep> delays;
+
+    for (auto i = 0; i < 100; ++i)
+    {
+        auto delay = policy(5).count();
+
+        BOOST_TEST(delay >= 500);
+        BOOST_TEST(delay <= 1000);
+
+        delays.insert(delay);
+    }
+
+    BOOST_TEST(delays.size() > 1);
+}
+
+BOOST_AUTO_TEST_CASE(InvalidSettingsTest)
+{
+    BOOST_CHECK_THROW((Policies::ReconnectPolicy{ std::chrono::milliseconds::zero(), std::chrono::milliseconds{ 10 } }), std::exception);
+    BOOST_CHECK_THROW((Policies::ReconnectPolicy{ std::chrono::milliseconds{ 1 }, std::chrono::milliseconds{ 10 }, 0.5 }), std::exception);
+    BOOST_CHECK_THROW((Policies::ReconnectPolicy{ std::chrono::milliseconds{ 1 }, std::chrono::milliseconds{ 10 }, 2.0, 1.5 }), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(TimeoutFactoryPolicyTest)
+{
+    Policies::TimeoutFactory timeoutFactory{
+        {}, {}, Policies::ReconnectPolicy{ std::chrono::milliseconds{ 10 }, std::chrono::milliseconds{ 50 }, 2.0, 0.0 } };
+
+    BOOST_TEST(timeoutFactory.GetReconnectPolicy()(1).count() == 20);
+    BOOST_TEST(Policies::TimeoutFactory{}.GetReconnectPolicy()(1).count() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
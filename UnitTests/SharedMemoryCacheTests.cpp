@@ -2,6 +2,7 @@
 #include "IPC/SharedMemoryCache.h"
 #include "IPC/SharedMemory.h"
 #include "IPC/detail/RandomString.h"
+#include <thread>
 
 using namespace IPC;
 
@@ -38,4 +39,101 @@ BOOST_AUTO_TEST_CASE(OwnershipTest)
     BOOST_CHECK_THROW(cache.Open(name.c_str()), std::exception);
 }
 
+BOOST_AUTO_TEST_CASE(StatisticsTest)
+{
+    SharedMemoryCache cache;
+
+    BOOST_TEST(cache.GetStatistics().m_memoryCount == 0);
+
+    auto m1 = cache.Create(detail::GenerateRandomString().c_str(), 64 * 1024);
+    auto m2 = cache.Create(detail::GenerateRandomString().c_str(), 128 * 1024);
+
+    m1->Construct<int>("X");
+    m2->Construct<int>("X");
+    m2->Construct<int>("Y");
+
+    auto statistics = cache.GetStatistics();
+    BOOST_TEST(statistics.m_memoryCount == 2);
+    BOOST_TEST(statistics.m_total.m_size == m1->GetSize() + m2->GetSize());
+    BOOST_TEST(statistics.m_total.m_namedObjects == 3);
+    BOOST_TEST(statistics.m_total.m_largestFreeBlock == m2->GetStatistics().m_largestFreeBlock);
+
+    m1.reset();
+    BOOST_TEST(cache.GetStatistics().m_memoryCount == 1);
+}
+
+BOOST_AUTO_TEST_CASE(KeptMemoryTest)
+{
+    SharedMemoryCache::Options options;
+    options.m_capacity = 2;
+    options.m_ttl = std::chrono::milliseconds{ 100 };
+
+    SharedMemoryCache cache{ options };
+
+    auto name1 = detail::GenerateRandomString();
+    auto name2 = detail::GenerateRandomString();
+    auto name3 = detail::GenerateRandomString();
+
+    SharedMemory m1{ create_only, name1.c_str(), 1024 };
+    SharedMemory m2{ create_only, name2.c_str(), 1024 };
+    SharedMemory m3{ create_only, name3.c_str(), 1024 };
+
+    std::weak_ptr<SharedMemory> opened = cache.Open(name1.c_str());
+    BOOST_TEST(!opened.expired());
+    BOOST_TEST(cache.Open(name1.c_str()) == opened.lock());
+
+    auto statistics = cache.GetStatistics();
+    BOOST_TEST(statistics.m_keptCount == 1);
+    BOOST_TEST(statistics.m_hitCount == 1);
+    BOOST_TEST(statistics.m_missCount == 1);
+
+    cache.Open(name2.c_str());
+    cache.Open(name3.c_str());
+    BOOST_TEST(opened.expired());   // Least recently opened.
+    BOOST_TEST(cache.GetStatistics().m_keptCount == 2);
+
+    std::this_thread::sleep_for(options.m_ttl * 2);
+
+    cache.Open(name3.c_str());
+    statistics = cache.GetStatistics();
+    BOOST_TEST(statistics.m_keptCount == 1);
+    BOOST_TEST(statistics.m_memoryCount == 1);
+    BOOST_TEST(statistics.m_hitCount == 2);
+    BOOST_TEST(statistics.m_missCount == 3);
+
+    cache.Clear();
+    BOOST_TEST(cache.GetStatistics().m_memoryCount == 0);
+}
+
+BOOST_AUTO_TEST_CASE(KeptMemoryExpiryWithoutOpenTest)
+{
+    SharedMemoryCache::Options options;
+    options.m_capacity = 2;
+    options.m_ttl = std::chrono::milliseconds{ 100 };
+
+    SharedMemoryCache cache{ options };
+
+    auto name1 = detail::GenerateRandomString();
+    auto name2 = detail::GenerateRandomString();
+
+    SharedMemory m1{ create_only, name1.c_str(), 1024 };
+
+    std::weak_ptr<SharedMemory> opened = cache.Open(name1.c_str());
+    BOOST_TEST(cache.GetStatistics().m_keptCount == 1);
+
+    std::this_thread::sleep_for(options.m_ttl * 2);
+
+    auto statistics = cache.GetStatistics();
+    BOOST_TEST(opened.expired());
+    BOOST_TEST(statistics.m_keptCount == 0);
+    BOOST_TEST(statistics.m_memoryCount == 0);
+
+    opened = cache.Open(name1.c_str());
+    std::this_thread::sleep_for(options.m_ttl * 2);
+
+    auto created = cache.Create(name2.c_str(), 1024);
+    BOOST_TEST(opened.expired());
+    BOOST_TEST(cache.GetStatistics().m_memoryCount == 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -1,9 +1,13 @@
 #include "stdafx.h"
 #include "IPC/SharedMemory.h"
 #include "IPC/detail/RandomString.h"
+#include "IPC/detail/KernelProcess.h"
 #include <mutex>
 #include <condition_variable>
 #include <future>
+#include <thread>
+#include <vector>
+#include <string>
 
 #pragma warning(push)
 #include <boost/interprocess/containers/string.hpp>
@@ -233,6 +237,315 @@ BOOST_AUTO_TEST_CASE(AllocatorDefautInitTest)
     BOOST_TEST(v.size() == 100);
 }
 
+BOOST_AUTO_TEST_CASE(SizeClassAllocatorTest)
+{
+    auto name = detail::GenerateRandomString();
+
+    SharedMemory::Options options;
+    options.m_sizeClasses = true;
+
+    SharedMemory m1{ create_only, name.c_str(), 1024 * 1024, options };
+    SharedMemory m2{ open_only, name.c_str() };
+
+    auto freeSize = m1.GetFreeSize();
+
+    auto a1 = m1.GetAllocator<char>();
+    auto a2 = m2.GetAllocator<char>();
+
+    auto p = a1.allocate(100);
+    a2.deallocate(p, 100);  // Freed by the peer into the shared lists.
+    BOOST_TEST(m1.GetFreeSize() == freeSize);
+    BOOST_TEST(a1.allocate(120) == p);  // Reused from the same size class.
+    a1.deallocate(p, 120);
+
+    std::vector<decltype(p)> blocks;
+
+    try
+    {
+        for (;;)
+        {
+            blocks.push_back(a1.allocate(40));
+        }
+    }
+    catch (const std::exception&)
+    {}
+
+    BOOST_TEST(blocks.size() > 1000);
+
+    for (auto& block : blocks)
+    {
+        a2.deallocate(block, 40);
+    }
+
+    BOOST_TEST(m1.GetFreeSize() == freeSize);
+
+    auto size = freeSize / 2;
+    BOOST_CHECK_NO_THROW(a1.deallocate(a1.allocate(size), size));   // Cached blocks are returned to the tree.
+}
+
+BOOST_AUTO_TEST_CASE(ThreadCacheAllocatorTest)
+{
+    auto name = detail::GenerateRandomString();
+
+    SharedMemory::Options options;
+    options.m_threadCaches = true;
+
+    auto m1 = std::make_unique<SharedMemory>(create_only, name.c_str(), 1024 * 1024, options);
+    SharedMemory m2{ open_only, name.c_str() };
+
+    auto freeSize = m2.GetFreeSize();
+
+    auto a1 = m1->GetAllocator<char>();
+    auto a2 = m2.GetAllocator<char>();
+
+    bool reused = false, cached = false;
+
+    std::thread{ [&]
+    {
+        auto p = a1.allocate(100);
+        a1.deallocate(p, 100);
+        reused = (a1.allocate(100) == p);   // Reused from the thread cache.
+        cached = (m2.GetFreeSize() < freeSize);
+
+        std::thread{ [&] { a2.deallocate(p, 100); } }.join();     // Freed by the peer.
+    } }.join();
+
+    BOOST_TEST(reused);
+    BOOST_TEST(cached);
+    BOOST_TEST(m2.GetFreeSize() == freeSize);    // Caches are flushed when threads exit.
+
+    {
+        boost::interprocess::vector<int, SharedMemory::Allocator<int>> v{ m1->GetAllocator<int>() };
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            v.push_back(i);
+        }
+    }
+
+    a2.deallocate(a1.allocate(100), 100);
+    BOOST_TEST(m2.GetFreeSize() < freeSize);
+
+    m1.reset();
+    BOOST_TEST(m2.GetFreeSize() < freeSize);    // Only the released memory is flushed.
+
+    m2 = SharedMemory{ open_only, name.c_str() };
+    BOOST_TEST(m2.GetFreeSize() == freeSize);
+}
+
+BOOST_AUTO_TEST_CASE(LargePagesTest)
+{
+    auto name = detail::GenerateRandomString();
+
+    SharedMemory::Options options;
+    options.m_largePages = true;
+
+    SharedMemory m1{ create_only, name.c_str(), 1024 * 1024, options };     // Falls back to regular pages when not available.
+    SharedMemory m2{ open_only, name.c_str() };
+
+    BOOST_TEST(m1.HasLargePages() == m2.HasLargePages());
+
+    m1.Construct<int>("X", 123);
+    BOOST_TEST(m2.Find<int>("X") == 123);
+    BOOST_CHECK_NO_THROW(m2.Destruct(&m2.Find<int>("X")));
+    BOOST_CHECK_THROW(m1.Find<int>("X"), std::exception);
+
+    BOOST_CHECK_THROW((SharedMemory{ create_only, name.c_str(), 1024 * 1024, options }), std::exception);
+
+    name = detail::GenerateRandomString();
+    SharedMemory m3{ create_only, name.c_str(), 1024 };
+    BOOST_TEST(!m3.HasLargePages());
+}
+
+BOOST_AUTO_TEST_CASE(PrefaultTest)
+{
+    auto name = detail::GenerateRandomString();
+
+    SharedMemory::Options options;
+    options.m_prefault = true;
+
+    SharedMemory m1{ create_only, name.c_str(), 1024 * 1024, options };
+    SharedMemory m2{ open_only, name.c_str() };
+
+    auto& x = m1.Construct<int>("X", 123);
+
+    BOOST_TEST(m2.Prefault());
+    BOOST_TEST(!m2.IsLocked());
+
+    auto timings = m2.GetTimings();
+    BOOST_TEST(m2.Prefault());  // Already touched, not walked again.
+    BOOST_TEST(m2.GetTimings().m_prefault.count() == timings.m_prefault.count());
+    BOOST_TEST(x == 123);
+    BOOST_TEST(m2.Find<int>("X") == 123);
+
+    auto locked = m2.Prefault(true);
+    BOOST_TEST(locked == m2.IsLocked());
+
+    SharedMemory m3{ std::move(m2) };
+    BOOST_TEST(locked == m3.IsLocked());
+    BOOST_TEST(m3.Find<int>("X") == 123);
+}
+
+BOOST_AUTO_TEST_CASE(GrowableMemoryTest)
+{
+    auto name = detail::GenerateRandomString();
+
+    SharedMemory::Options options;
+    options.m_maxSize = 4 * 1024 * 1024;
+
+    SharedMemory m1{ create_only, name.c_str(), 64 * 1024, options };
+    SharedMemory m2{ open_only, name.c_str() };
+
+    auto initialSize = m1.GetSize();
+    BOOST_TEST(initialSize < 64 * 1024);
+    BOOST_TEST(m1.GetMaxSize() > initialSize);
+    BOOST_TEST(m2.GetMaxSize() == m1.GetMaxSize());
+
+    using Vector = boost::interprocess::vector<int, SharedMemory::Allocator<int>>;
+
+    auto& v1 = m1.Construct<Vector>("V", m1.GetAllocator<int>());
+
+    for (int i = 0; i < 256 * 1024; ++i)
+    {
+        v1.push_back(i);
+    }
+
+    BOOST_TEST(m1.GetSize() > initialSize);
+    BOOST_TEST(m2.GetSize() == m1.GetSize());
+
+    auto& v2 = m2.Find<Vector>("V");
+    BOOST_TEST(v2.size() == 256 * 1024);
+    BOOST_TEST(v2.back() == 256 * 1024 - 1);
+
+    v2.push_back(-1);
+    BOOST_TEST(v1.back() == -1);
+
+    BOOST_CHECK_THROW(m2.GetAllocator<char>().allocate(4 * 1024 * 1024), std::exception);
+    BOOST_TEST(m1.GetSize() <= m1.GetMaxSize());
+
+    BOOST_CHECK_NO_THROW(m2.Destruct(&v2));
+}
+
+BOOST_AUTO_TEST_CASE(AnonymousMemoryTest)
+{
+    SharedMemory m1{ create_only, nullptr, 1024 };
+    BOOST_TEST(m1.GetName().empty());
+
+    m1.Construct<int>("X", 123);
+
+    SharedMemory m2{ open_only, m1.Share(detail::KernelProcess::GetCurrentProcessId()) };
+    BOOST_TEST(m2.GetName().empty());
+    BOOST_TEST(m2.Find<int>("X") == 123);
+
+    m2.Find<int>("X") = 456;
+    BOOST_TEST(m1.Find<int>("X") == 456);
+
+    auto section = m1.Share(detail::KernelProcess::GetCurrentProcessId());
+    m1 = SharedMemory{ create_only, nullptr, 1024 };
+    BOOST_CHECK_THROW(m1.Find<int>("X"), std::exception);
+
+    SharedMemory m3{ open_only, section };     // Shared handles keep the memory alive.
+    BOOST_TEST(m3.Find<int>("X") == 456);
+}
+
+BOOST_AUTO_TEST_CASE(HashedIndexTest)
+{
+    auto name = detail::GenerateRandomString();
+
+    SharedMemory::Options options;
+    options.m_hashedIndex = true;
+
+    SharedMemory m1{ create_only, name.c_str(), 1024 * 1024, options };
+    SharedMemory m2{ open_only, name.c_str() };
+
+    std::vector<std::string> names;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        names.push_back(name + std::to_string(i));
+        m1.Construct<int>(names.back().c_str(), i);
+    }
+
+    m1.Construct<double>(unique_instance, 0.5);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        BOOST_TEST(m2.Find<int>(names[i].c_str()) == i);
+    }
+
+    BOOST_TEST(m2.Find<double>(unique_instance) == 0.5);
+    BOOST_CHECK_THROW(m2.Construct<int>(names.front().c_str()), std::exception);
+    BOOST_CHECK_THROW(m2.Find<int>(name.c_str()), std::exception);
+
+    for (int i = 0; i < 1000; i += 2)
+    {
+        BOOST_CHECK_NO_THROW(m2.Destruct(&m2.Find<int>(names[i].c_str())));
+        BOOST_CHECK_THROW(m1.Find<int>(names[i].c_str()), std::exception);
+        BOOST_TEST(m1.Find<int>(names[i + 1].c_str()) == i + 1);
+    }
+
+    BOOST_CHECK_NO_THROW(m1.Destruct(&m1.Find<double>(unique_instance)));
+    BOOST_CHECK_THROW(m2.Find<double>(unique_instance), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(StatisticsTest)
+{
+    auto name = detail::GenerateRandomString();
+
+    SharedMemory::Options options;
+    options.m_sizeClasses = true;
+
+    SharedMemory m1{ create_only, name.c_str(), 1024 * 1024, options };
+    SharedMemory m2{ open_only, name.c_str() };
+
+    auto initial = m1.GetStatistics();
+    BOOST_TEST(initial.m_size == m1.GetSize());
+    BOOST_TEST(initial.m_freeSize + initial.m_cachedSize + initial.m_usedSize == initial.m_size);
+    BOOST_TEST(initial.m_largestFreeBlock <= initial.m_freeSize);
+    BOOST_TEST(initial.m_namedObjects == 0);
+    BOOST_TEST(initial.m_uniqueObjects == 0);
+
+    m1.Construct<int>("X", 1);
+    m1.Construct<int>(unique_instance, 2);
+
+    std::vector<std::size_t*> blocks;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        blocks.push_back(&m1.Construct<std::size_t>(anonymous_instance));
+    }
+
+    for (std::size_t i = 0; i < blocks.size(); i += 2)
+    {
+        m1.Destruct(blocks[i]);
+    }
+
+    auto current = m2.GetStatistics();
+    BOOST_TEST(current.m_namedObjects == 1);
+    BOOST_TEST(current.m_uniqueObjects == 1);
+    BOOST_TEST(current.m_usedSize > initial.m_usedSize);
+    BOOST_TEST(current.m_cachedSize > 0);
+    BOOST_TEST(current.m_highWaterMark >= current.m_usedSize + current.m_cachedSize);
+
+    std::size_t freeBlocks = 0;
+
+    for (auto count : current.m_freeBlocks)
+    {
+        freeBlocks += count;
+    }
+
+    BOOST_TEST(freeBlocks >= 1);
+
+    for (std::size_t i = 1; i < blocks.size(); i += 2)
+    {
+        m1.Destruct(blocks[i]);
+    }
+
+    auto released = m1.GetStatistics();
+    BOOST_TEST(released.m_usedSize < current.m_usedSize);
+    BOOST_TEST(released.m_highWaterMark >= current.m_highWaterMark);
+}
+
 BOOST_AUTO_TEST_CASE(DeleterTest)
 {
     auto name = detail::GenerateRandomString();
@@ -2,6 +2,8 @@
 #include "IPC/detail/SpinLock.h"
 #include "IPC/detail/RecursiveSpinLock.h"
 #include <future>
+#include <thread>
+#include <vector>
 
 using namespace IPC;
 
@@ -40,4 +42,43 @@ BOOST_AUTO_TEST_CASE(RecursiveLockTest)
     BOOST_TEST(result.get());
 }
 
+BOOST_AUTO_TEST_CASE(ContentionTest)
+{
+    detail::SpinLock lock;
+    std::size_t count{ 0 };
+
+    constexpr std::size_t c_threadCount = 8;
+    constexpr std::size_t c_iterationCount = 10000;
+
+    std::vector<std::future<void>> results;
+
+    for (std::size_t i = 0; i < c_threadCount; ++i)
+    {
+        results.push_back(std::async(
+            std::launch::async,
+            [&]
+            {
+                for (std::size_t j = 0; j < c_iterationCount; ++j)
+                {
+                    std::lock_guard<detail::SpinLock> guard{ lock };
+                    ++count;
+                }
+            }));
+    }
+
+    lock.lock();
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });   // Force the waiters to block.
+    lock.unlock();
+
+    for (auto& result : results)
+    {
+        result.get();
+    }
+
+    BOOST_TEST(count == c_threadCount * c_iterationCount);
+    BOOST_TEST(lock.try_lock());
+    BOOST_TEST(!lock.try_lock());
+    lock.unlock();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
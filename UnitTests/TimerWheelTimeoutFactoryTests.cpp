@@ -0,0 +1,254 @@
+#include "stdafx.h"
+#include "IPC/Policies/TimerWheelTimeoutFactory.h"
+#include "IPC/Policies/TimeoutFactory.h"
+#include "IPC/Policies/TransactionManager.h"
+#include <functional>
+#include <condition_variable>
+#include <mutex>
+#include <future>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <type_traits>
+
+using namespace IPC;
+
+
+BOOST_AUTO_TEST_SUITE(TimerWheelTimeoutFactoryTests)
+
+static_assert(std::is_copy_constructible<Policies::TimerWheelTimeoutFactory>::value, "TimerWheelTimeoutFactory should be copy constructible.");
+static_assert(std::is_copy_assignable<Policies::TimerWheelTimeoutFactory>::value, "TimerWheelTimeoutFactory should be copy assignable.");
+
+BOOST_AUTO_TEST_CASE(InvocationTest)
+{
+    Policies::TimerWheelTimeoutFactory factory{ std::chrono::milliseconds{ 3 } };
+
+    std::mutex lock;
+    bool done = false;
+    std::condition_variable cvDone;
+
+    std::function<void()> timeout = factory(
+        [&]
+        {
+            std::lock_guard<std::mutex> guard{ lock };
+            done = true;
+            cvDone.notify_one();
+        });
+
+    auto start = std::chrono::steady_clock::now();
+
+    timeout();
+    {
+        std::unique_lock<std::mutex> guard{ lock };
+        cvDone.wait(guard, [&] { return done; });
+    }
+    BOOST_TEST(done);
+    BOOST_TEST((std::chrono::steady_clock::now() - start >= std::chrono::milliseconds{ 3 }));
+}
+
+BOOST_AUTO_TEST_CASE(CompletionTest)
+{
+    Policies::TimerWheelTimeoutFactory factory{ std::chrono::milliseconds{ 3 } };
+
+    std::mutex lock;
+    bool processing = false, complete = false;
+    std::condition_variable cvProcessing, cvComplete;
+
+    std::function<void()> timeout = factory(
+        [&]
+        {
+            std::unique_lock<std::mutex> guard{ lock };
+            processing = true;
+            cvProcessing.notify_one();
+            cvComplete.wait(guard, [&] { return complete; });
+        });
+
+    BOOST_TEST(!!timeout);
+    timeout();
+    {
+        std::unique_lock<std::mutex> guard{ lock };
+        cvProcessing.wait(guard, [&] { return processing; });
+    }
+
+    auto result = std::async(std::launch::async, [&] { timeout = {}; return true; });
+
+    BOOST_TEST((result.wait_for(std::chrono::milliseconds{ 3 }) == std::future_status::timeout));
+    {
+        std::lock_guard<std::mutex> guard{ lock };
+        complete = true;
+        cvComplete.notify_one();
+    }
+    BOOST_TEST(result.get());
+    BOOST_TEST(!timeout);
+}
+
+BOOST_AUTO_TEST_CASE(SelfDestructionTest)
+{
+    std::mutex lock;
+    bool done = false;
+    std::condition_variable cvDone;
+
+    std::function<void()> timeout;
+    {
+        Policies::TimerWheelTimeoutFactory factory{ std::chrono::milliseconds{ 3 } };
+
+        timeout = factory(
+            [&]
+            {
+                timeout = {};
+
+                std::lock_guard<std::mutex> guard{ lock };
+                done = true;
+                cvDone.notify_one();
+            });
+    }
+
+    BOOST_TEST(!!timeout);
+    timeout();
+    {
+        std::unique_lock<std::mutex> guard{ lock };
+        cvDone.wait(guard, [&] { return done; });
+    }
+    BOOST_TEST(!timeout);
+}
+
+BOOST_AUTO_TEST_CASE(OneTimeTimeoutTest)
+{
+    Policies::TimerWheelTimeoutFactory factory;
+
+    std::mutex lock;
+    std::size_t count = 0;
+    std::condition_variable cvCount;
+
+    std::function<void(const std::chrono::milliseconds&)> timeout = factory(
+        [&]
+        {
+            std::lock_guard<std::mutex> guard{ lock };
+            ++count;
+            cvCount.notify_one();
+        });
+
+    timeout(std::chrono::milliseconds{ 2 });
+
+    BOOST_TEST(!!timeout);
+    {
+        std::unique_lock<std::mutex> guard{ lock };
+        cvCount.wait(guard, [&] { return count == 1; });
+    }
+    BOOST_TEST(count == 1);
+    {
+        std::unique_lock<std::mutex> guard{ lock };
+        BOOST_TEST(!cvCount.wait_for(guard, std::chrono::milliseconds{ 4 }, [&] { return count == 2; }));
+    }
+    BOOST_TEST(count == 1);
+}
+
+BOOST_AUTO_TEST_CASE(DeactivationTest)
+{
+    Policies::TimerWheelTimeoutFactory factory;
+
+    std::mutex lock;
+    bool processing = false, complete = false;
+    std::condition_variable cvProcessing, cvComplete;
+
+    auto timeout = factory(
+        [&]
+        {
+            std::unique_lock<std::mutex> guard{ lock };
+            processing = true;
+            cvProcessing.notify_one();
+            cvComplete.wait(guard, [&] { return complete; });
+        });
+
+    timeout(std::chrono::milliseconds{ 2 });
+    {
+        std::unique_lock<std::mutex> guard{ lock };
+        cvProcessing.wait(guard, [&] { return processing; });
+    }
+
+    auto result = std::async(std::launch::async, [&] { timeout(nullptr); return true; });
+    BOOST_TEST((result.wait_for(std::chrono::milliseconds{ 3 }) == std::future_status::timeout));
+    {
+        std::lock_guard<std::mutex> guard{ lock };
+        complete = true;
+        cvComplete.notify_one();
+    }
+    BOOST_TEST(result.get());
+}
+
+BOOST_AUTO_TEST_CASE(CascadedTimeoutTest)
+{
+    Policies::TimerWheelTimeoutFactory factory;
+
+    std::atomic_size_t count{ 0 };
+    std::chrono::steady_clock::time_point fired;
+
+    auto shortTimeout = factory([&] { ++count; });
+    auto longTimeout = factory([&] { fired = std::chrono::steady_clock::now(); ++count; });
+
+    auto start = std::chrono::steady_clock::now();
+
+    longTimeout(std::chrono::milliseconds{ 150 });      // Beyond the first level of the wheel.
+    shortTimeout(std::chrono::milliseconds{ 100 });
+    shortTimeout(nullptr);
+
+    while (count == 0)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+    }
+
+    BOOST_TEST(count == 1);
+    BOOST_TEST((fired - start >= std::chrono::milliseconds{ 150 }));
+}
+
+BOOST_AUTO_TEST_CASE(InvalidTickTest)
+{
+    BOOST_CHECK_THROW(Policies::TimerWheelTimeoutFactory({}, std::chrono::milliseconds::zero()), std::exception);
+}
+
+template <typename TimeoutFactory>
+std::chrono::nanoseconds MeasureTransactions(std::size_t threadCount, std::size_t count)
+{
+    Policies::TransactionManager<std::size_t, TimeoutFactory> manager{ TimeoutFactory{} };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i != threadCount; ++i)
+    {
+        threads.emplace_back(
+            [&]
+            {
+                for (std::size_t j = 0; j != count; ++j)
+                {
+                    manager.EndTransaction(manager.BeginTransaction(j));
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    return (std::chrono::steady_clock::now() - start) / (threadCount * count);
+}
+
+BOOST_AUTO_TEST_CASE(TransactionBenchmark, *boost::unit_test::disabled())
+{
+    constexpr std::size_t Count = 100000;
+
+    for (std::size_t threadCount : { 1, 4, 8 })
+    {
+        auto pool = MeasureTransactions<Policies::TimeoutFactory>(threadCount, Count);
+        auto wheel = MeasureTransactions<Policies::TimerWheelTimeoutFactory>(threadCount, Count);
+
+        BOOST_TEST_MESSAGE("Begin/EndTransaction on " << threadCount << " thread(s): TimeoutFactory "
+            << pool.count() << "ns, TimerWheelTimeoutFactory " << wheel.count() << "ns.");
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
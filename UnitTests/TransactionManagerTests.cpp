@@ -158,4 +158,37 @@ BOOST_AUTO_TEST_CASE(DefaultTimeoutTest)
     check();
 }
 
+BOOST_AUTO_TEST_CASE(StaleIdTest)
+{
+    Policies::TransactionManager<int> transactions;
+
+    auto id1 = transactions.BeginTransaction(1);
+    BOOST_TEST(*transactions.EndTransaction(id1) == 1);
+
+    auto id2 = transactions.BeginTransaction(2);
+    BOOST_TEST(id2 != id1);     // The same transaction is reused with the next generation.
+
+    BOOST_TEST(!transactions.EndTransaction(id1));
+    BOOST_TEST(*transactions.EndTransaction(id2) == 2);
+}
+
+BOOST_AUTO_TEST_CASE(StaleTimeoutTest)
+{
+    using TimeoutFactory = UnitTest::Mocks::TimeoutFactory;
+
+    TimeoutFactory timeouts;
+
+    Policies::TransactionManager<int, TimeoutFactory> transactions{ timeouts };
+
+    auto id1 = transactions.BeginTransaction(1);
+
+    BOOST_TEST(timeouts->size() == 1);
+    (*timeouts->front().first.lock())();
+
+    auto id2 = transactions.BeginTransaction(2);
+
+    BOOST_TEST(!transactions.EndTransaction(id1));     // Late response for the timed out request.
+    BOOST_TEST(*transactions.EndTransaction(id2) == 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
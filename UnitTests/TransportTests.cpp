@@ -10,6 +10,7 @@
 #include <mutex>
 #include <condition_variable>
 #include <future>
+#include <functional>
 
 #pragma warning(push)
 #include <boost/interprocess/containers/string.hpp>
@@ -245,6 +246,89 @@ BOOST_AUTO_TEST_CASE(AcceptConnectTest)
     BOOST_TEST(y == std::sqrt(x), boost::test_tools::tolerance(0.0001));
 }
 
+BOOST_AUTO_TEST_CASE(ClientPoolTest)
+{
+    std::mutex lock;
+    std::condition_variable received;
+    std::vector<std::function<void()>> responses;
+
+    auto serverHandler = [&](int x, auto&& callback)
+    {
+        auto sharedCallback = std::make_shared<std::decay_t<decltype(callback)>>(std::forward<decltype(callback)>(callback));
+
+        std::lock_guard<std::mutex> guard{ lock };
+        responses.push_back([x, sharedCallback] { (*sharedCallback)(x * 2); });
+        received.notify_one();
+    };
+
+    auto respond = [&](std::size_t count)
+    {
+        std::unique_lock<std::mutex> guard{ lock };
+        received.wait(guard, [&] { return responses.size() == count; });
+
+        for (auto& response : responses)
+        {
+            response();
+        }
+
+        responses.clear();
+    };
+
+    auto name = IPC::detail::GenerateRandomString();
+
+    using Transport = IPC::Transport<int, int, Traits>;
+
+    Transport transport;
+
+    auto serversAccessor = transport.AcceptServers(name.c_str(), [&](auto&&...) { return serverHandler; });
+
+    {
+        auto pool = transport.ConnectClientPool(name.c_str(), 3, Transport::ClientPool::Balancing::RoundRobin, false);
+
+        BOOST_TEST(pool.GetSize() == 3);
+        BOOST_TEST(serversAccessor()->size() == 3);
+
+        std::vector<std::future<int>> results;
+
+        for (int x = 0; x != 3; ++x)
+        {
+            results.push_back(pool(x));
+        }
+
+        for (std::size_t i = 0; i != pool.GetSize(); ++i)
+        {
+            BOOST_TEST(pool.GetInFlightCount(i) == 1);
+        }
+
+        respond(3);
+
+        for (int x = 0; x != 3; ++x)
+        {
+            BOOST_TEST(results[x].get() == x * 2);
+        }
+
+        for (std::size_t i = 0; i != pool.GetSize(); ++i)
+        {
+            BOOST_TEST(pool.GetInFlightCount(i) == 0);
+        }
+    }
+    {
+        auto pool = transport.ConnectClientPool(name.c_str(), 2, Transport::ClientPool::Balancing::KeyHash, false);
+
+        auto result1 = pool.Call(3, 10);
+        auto result2 = pool.Call(5, 20);
+
+        BOOST_TEST(pool.GetInFlightCount(0) == 0);
+        BOOST_TEST(pool.GetInFlightCount(1) == 2);
+
+        respond(2);
+
+        BOOST_TEST(result1.get() == 20);
+        BOOST_TEST(result2.get() == 40);
+        BOOST_TEST(pool.GetInFlightCount(1) == 0);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(ReverseConnectionAcceptConnectTest)
 {
     auto serverHandler = [](int x, auto&& callback)
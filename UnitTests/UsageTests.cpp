@@ -4,7 +4,9 @@
 #include "IPC/Connect.h"
 #include "IPC/Connector.h"
 #include "IPC/detail/RandomString.h"
+#include "IPC/Policies/BusyPollReceiverFactory.h"
 #include "TraitsMock.h"
+#include "AllocationCounter.h"
 #include <cmath>
 #include <memory>
 #include <vector>
@@ -13,6 +15,10 @@
 #include <mutex>
 #include <condition_variable>
 #include <future>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <utility>
 
 #pragma warning(push)
 #include <boost/interprocess/containers/string.hpp>
@@ -356,6 +362,117 @@ BOOST_AUTO_TEST_CASE(DynamicDataTest)
     BOOST_TEST(*result == "IPC");
 }
 
+struct PollingTraits : Traits
+{
+    using ReceiverFactory = IPC::Policies::BusyPollReceiverFactory;
+};
+
+BOOST_AUTO_TEST_CASE(ZeroAllocationRequestResponseTest)
+{
+    // Busy polling keeps the set of threads fixed and does not allocate while draining the queues.
+    // Handlers attach the receiver threads to the counter, other threads of the process are not counted.
+    std::atomic<const IPC::UnitTest::AllocationCounter*> tracker{ nullptr };
+
+    auto attach = [&tracker]
+    {
+        if (auto allocations = tracker.load())
+        {
+            allocations->Attach();
+        }
+    };
+
+    auto name = IPC::detail::GenerateRandomString();
+
+    auto serversAccessor = IPC::AcceptServers<int, int, PollingTraits>(
+        name.c_str(), [attach](auto&&...) { return [attach](int x, auto&& callback) { attach(); callback(x + 1); }; });
+
+    IPC::ClientConnector<int, int, PollingTraits> connector;
+    IPC::Client<int, int, PollingTraits> client{ connector.Connect(name.c_str()).get(), [] {} };
+
+    std::atomic_size_t sum{ 0 };
+
+    auto roundTrips = [&](int count)
+    {
+        for (int i = 0; i != count; ++i)
+        {
+            auto expected = sum + i + 1;
+
+            client(i, [&sum, &attach](int y) { attach(); sum += y; });
+
+            while (sum != expected)
+            {
+                std::this_thread::yield();
+            }
+        }
+    };
+
+    roundTrips(1000);   // Warms up the transaction pool and the per-thread memory caches.
+
+    std::size_t allocationCount;
+    {
+        IPC::UnitTest::AllocationCounter allocations;
+        tracker = &allocations;
+
+        roundTrips(1);      // Attaches the receiver threads.
+
+        auto start = allocations.GetCount();
+        roundTrips(1000);
+        allocationCount = allocations.GetCount() - start;
+
+        tracker = nullptr;
+    }
+
+    BOOST_TEST(allocationCount == 0);
+}
+
+template <typename ClientTraits>
+std::pair<std::chrono::nanoseconds, std::chrono::nanoseconds> MeasureSynchronousCalls(std::size_t count)
+{
+    auto name = IPC::detail::GenerateRandomString();
+
+    auto serversAccessor = IPC::AcceptServers<int, int, ClientTraits>(
+        name.c_str(), [](auto&&...) { return [](int x, auto&& callback) { callback(x + 1); }; });
+
+    IPC::ClientConnector<int, int, ClientTraits> connector;
+    IPC::Client<int, int, ClientTraits> client{ connector.Connect(name.c_str()).get(), [] {} };
+
+    auto measure = [&](auto&& call)
+    {
+        for (std::size_t i = 0; i != count / 10; ++i)
+        {
+            call(static_cast<int>(i));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (std::size_t i = 0; i != count; ++i)
+        {
+            call(static_cast<int>(i));
+        }
+
+        return (std::chrono::steady_clock::now() - start) / count;
+    };
+
+    auto future = measure([&](int x) { client(x).get(); });
+    auto completion = measure([&](int x) { client.Call(x).get(); });
+
+    return{ future, completion };
+}
+
+BOOST_AUTO_TEST_CASE(SynchronousCallBenchmark, *boost::unit_test::disabled())
+{
+    constexpr std::size_t Count = 100000;
+
+    auto events = MeasureSynchronousCalls<Traits>(Count);
+    auto polling = MeasureSynchronousCalls<PollingTraits>(Count);
+
+    BOOST_TEST_MESSAGE("Synchronous round trip with the default ReceiverFactory: std::future "
+        << events.first.count() << "ns, Completion " << events.second.count() << "ns.");
+
+    BOOST_TEST_MESSAGE("Synchronous round trip with BusyPollReceiverFactory: std::future "
+        << polling.first.count() << "ns, Completion " << polling.second.count() << "ns.");
+}
+
 BOOST_AUTO_TEST_CASE(StressTest)
 {
     // TODO: